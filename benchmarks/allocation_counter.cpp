@@ -0,0 +1,51 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local allocation_counter counter;
+
+void* counted_allocation(std::size_t size) {
+    ++counter.allocations;
+    counter.bytes += size;
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+/*static*/ allocation_counter allocation_counter::this_thread() {
+    return counter;
+}
+
+allocation_counter allocation_counter::operator-(const allocation_counter& other) const {
+    return allocation_counter{allocations - other.allocations, bytes - other.bytes};
+}
+
+void* operator new(std::size_t size) {
+    return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_allocation(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,24 @@
+#ifndef _ALLOCATION_COUNTER_
+#define _ALLOCATION_COUNTER_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Counts heap allocations made through the global operator new by the
+ * calling thread. Linking allocation_counter replaces the global operator
+ * new/delete of the whole executable.
+ */
+struct allocation_counter {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+
+    /**
+     * @brief Counters of the calling thread since its start
+     */
+    static allocation_counter this_thread();
+
+    allocation_counter operator-(const allocation_counter&) const;
+};
+
+#endif // _ALLOCATION_COUNTER_
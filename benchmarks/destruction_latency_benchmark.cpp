@@ -0,0 +1,208 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "extendable_histogram.h"
+#include "extendable_unique_ownership.h"
+
+/**
+ * Quantifies the "very short period of time" for which a scoped_extender may
+ * extend a resource beyond the lifetime of its unique_extendable_ptr.
+ *
+ * An owner thread keeps resetting and recreating resources while reader
+ * threads lock them and hold the scoped_extender for a randomized
+ * (exponentially distributed) time. With some probability a reader sleeps
+ * while holding, which forces it off the CPU the same way an unlucky
+ * preemption would, and the readers may oversubscribe the available cores.
+ *
+ * Reports the distribution of the delay between unique_extendable_ptr::reset()
+ * and the destructor of the resource.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock_type::now().time_since_epoch()).count();
+}
+
+struct options {
+    std::size_t objects = 256;
+    std::size_t readers = 0;
+    /**
+     * @brief Readers per hardware thread, used when readers is 0
+     */
+    double oversubscription = 2.0;
+    std::size_t resets = 200000;
+    std::int64_t hold_mean_ns = 500;
+    /**
+     * @brief Probability that a reader sleeps while holding a scoped_extender
+     */
+    double preempt_probability = 0.001;
+    std::int64_t preempt_us = 100;
+};
+
+latency_histogram all_delays_ns;
+latency_histogram extended_delays_ns;
+std::thread::id owner_thread;
+
+struct resource {
+    ~resource() {
+        const auto reset_time = reset_time_ns.load(std::memory_order_relaxed);
+        if (reset_time == 0) {
+            return;
+        }
+        const auto delay = static_cast<std::uint64_t>(now_ns() - reset_time);
+        all_delays_ns.record(delay);
+        if (std::this_thread::get_id() != owner_thread) {
+            // destroyed by the release of a scoped_extender
+            extended_delays_ns.record(delay);
+        }
+    }
+
+    std::atomic<std::int64_t> value{0};
+    std::atomic<std::int64_t> reset_time_ns{0};
+};
+
+struct slot {
+    std::mutex mutex;
+    unique_extendable_ptr<resource> owner;
+    weak_extender<resource> weak;
+};
+
+void spin_for(std::int64_t nanoseconds) {
+    const auto until = now_ns() + nanoseconds;
+    while (now_ns() < until) {}
+}
+
+weak_extender<resource> read_handle(slot& slot) {
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.weak;
+}
+
+void run_reader(const options& options, std::vector<slot>& slots, const std::atomic<bool>& stopping, unsigned seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<std::size_t> index(0, slots.size() - 1);
+    std::exponential_distribution<double> hold(1.0 / static_cast<double>(std::max<std::int64_t>(options.hold_mean_ns, 1)));
+    std::bernoulli_distribution preempt(options.preempt_probability);
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        const auto weak = read_handle(slots[index(random)]);
+        const auto& scoped = weak.lock();
+        if (scoped.empty()) {
+            continue;
+        }
+        scoped->value.fetch_add(1, std::memory_order_relaxed);
+        if (preempt(random)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(options.preempt_us));
+        } else {
+            spin_for(static_cast<std::int64_t>(hold(random)));
+        }
+    }
+}
+
+void print_histogram(const char* name, const histogram_snapshot& histogram) {
+    std::printf("%-28s p50 %9.2f us  p99 %9.2f us  p99.9 %9.2f us  p99.99 %9.2f us  max %9.2f us  (%llu)\n",
+        name,
+        histogram.percentile(50) / 1000.0,
+        histogram.percentile(99) / 1000.0,
+        histogram.percentile(99.9) / 1000.0,
+        histogram.percentile(99.99) / 1000.0,
+        histogram.max / 1000.0,
+        static_cast<unsigned long long>(histogram.count));
+}
+
+bool parse(int argc, char** argv, options& result) {
+    for (int i = 1; i < argc; ++i) {
+        const char* argument = argv[i];
+        const char* value = std::strchr(argument, '=');
+        if (value == nullptr) {
+            return false;
+        }
+        ++value;
+        if (std::strncmp(argument, "--objects=", 10) == 0) {
+            result.objects = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--readers=", 10) == 0) {
+            result.readers = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--oversubscription=", 19) == 0) {
+            result.oversubscription = std::strtod(value, nullptr);
+        } else if (std::strncmp(argument, "--resets=", 9) == 0) {
+            result.resets = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--hold-mean-ns=", 15) == 0) {
+            result.hold_mean_ns = std::strtoll(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--preempt-probability=", 22) == 0) {
+            result.preempt_probability = std::strtod(value, nullptr);
+        } else if (std::strncmp(argument, "--preempt-us=", 13) == 0) {
+            result.preempt_us = std::strtoll(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return result.objects != 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr,
+            "usage: %s [--objects=N] [--readers=N] [--oversubscription=X] [--resets=N]"
+            " [--hold-mean-ns=N] [--preempt-probability=0..1] [--preempt-us=N]\n", argv[0]);
+        return 1;
+    }
+    if (options.readers == 0) {
+        const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+        options.readers = std::max<std::size_t>(1, static_cast<std::size_t>(hardware * options.oversubscription));
+    }
+
+    owner_thread = std::this_thread::get_id();
+    std::vector<slot> slots(options.objects);
+    for (auto& slot : slots) {
+        slot.owner = make_unique_extendable<resource>();
+        slot.weak = weak_extender<resource>(slot.owner);
+    }
+
+    std::atomic<bool> stopping{false};
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < options.readers; ++i) {
+        readers.emplace_back([&, i] { run_reader(options, slots, stopping, static_cast<unsigned>(i + 1)); });
+    }
+
+    std::mt19937_64 random(0);
+    std::uniform_int_distribution<std::size_t> index(0, slots.size() - 1);
+    for (std::size_t i = 0; i < options.resets; ++i) {
+        auto& slot = slots[index(random)];
+        auto replacement = make_unique_extendable<resource>();
+        weak_extender<resource> weak(replacement);
+
+        slot.owner->reset_time_ns.store(now_ns(), std::memory_order_relaxed);
+        slot.owner.reset();
+
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.owner = std::move(replacement);
+        slot.weak = weak;
+    }
+
+    stopping.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    std::printf("objects %zu, readers %zu, resets %zu, hold mean %lld ns, preempt %.4f x %lld us\n",
+        options.objects, options.readers, options.resets,
+        static_cast<long long>(options.hold_mean_ns),
+        options.preempt_probability, static_cast<long long>(options.preempt_us));
+    print_histogram("reset to destructor", all_delays_ns.snapshot());
+    print_histogram("  of them extended", extended_delays_ns.snapshot());
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "extendable_group.h"
+#include "extendable_unique_ownership.h"
+
+/**
+ * Measures the memory taken by a resource owned by this module: heap bytes
+ * and allocations per object (the control block with the resource_owner and
+ * the separately allocated resource) and the size of every handle, for a
+ * range of resource sizes and for every way of creating a resource.
+ * std::shared_ptr is measured as a reference point.
+ *
+ *   footprint_report                      prints the report
+ *   footprint_report --check=FILE         also fails if anything grew
+ *                                         compared to the baseline FILE
+ *   footprint_report --write-baseline=FILE
+ *
+ * Heap bytes are the sizes requested from operator new, so the baseline is
+ * specific to the standard library and the platform it was recorded with.
+ */
+
+namespace {
+
+template <std::size_t Size>
+struct payload {
+    char data[Size];
+};
+
+/**
+ * @brief Runs the tasks in place, so that the asynchronous construction is
+ * complete by the time the object is counted
+ */
+struct inline_executor {
+    void submit(std::function<void()> task) {
+        task();
+    }
+};
+
+struct measurement {
+    std::string name;
+    std::uint64_t bytes;
+};
+
+/**
+ * @brief Heap bytes and allocations per object created by create()
+ */
+template <typename Create>
+void measure_heap(std::vector<measurement>& result, const std::string& name, Create create) {
+    constexpr std::size_t object_count = 256;
+
+    std::vector<decltype(create())> objects;
+    objects.reserve(object_count);
+
+    const auto before = allocation_counter::this_thread();
+    for (std::size_t i = 0; i < object_count; ++i) {
+        objects.push_back(create());
+    }
+    const auto allocated = allocation_counter::this_thread() - before;
+
+    result.push_back({name + "/heap_bytes", allocated.bytes / object_count});
+    result.push_back({name + "/allocations", allocated.allocations / object_count});
+}
+
+/**
+ * @brief Heap bytes that stay allocated after reset() while a weak_extender
+ * to the resource is kept
+ */
+template <typename T>
+void measure_dead_control_block(std::vector<measurement>& result, const std::string& name) {
+    auto before = allocation_counter::this_thread();
+    auto unique = make_unique_extendable<T>();
+    weak_extender<T> weak(unique);
+    const auto allocated = allocation_counter::this_thread() - before;
+
+    // the resource itself is freed, only the control block stays allocated
+    const auto resource_bytes = sizeof(T);
+    unique.reset();
+    result.push_back({name + "/dead_heap_bytes", allocated.bytes - resource_bytes});
+}
+
+/**
+ * @brief Heap bytes and allocations per resource owned by an extendable_group
+ */
+template <typename T>
+void measure_group(std::vector<measurement>& result, const std::string& name) {
+    constexpr std::size_t object_count = 256;
+
+    std::vector<std::unique_ptr<T>> resources;
+    resources.reserve(object_count);
+
+    const auto before = allocation_counter::this_thread();
+    for (std::size_t i = 0; i < object_count; ++i) {
+        resources.push_back(std::make_unique<T>());
+    }
+    extendable_group<T> group(std::move(resources));
+    const auto allocated = allocation_counter::this_thread() - before;
+
+    result.push_back({name + "/heap_bytes", allocated.bytes / object_count});
+    result.push_back({name + "/allocations", allocated.allocations / object_count});
+}
+
+template <std::size_t Size>
+void measure_size(std::vector<measurement>& result) {
+    using resource = payload<Size>;
+    const auto suffix = "/" + std::to_string(Size);
+
+    measure_heap(result, "make_unique_extendable" + suffix, [] {
+        return make_unique_extendable<resource>();
+    });
+    measure_heap(result, "unique_extendable_ptr_from_unique_ptr" + suffix, [] {
+        return unique_extendable_ptr<resource>(std::make_unique<resource>());
+    });
+    // includes the transient construction task
+    measure_heap(result, "make_unique_extendable_async" + suffix, [] {
+        inline_executor executor;
+        return make_unique_extendable_async<resource>(executor);
+    });
+    measure_group<resource>(result, "extendable_group" + suffix);
+    measure_heap(result, "reference_make_shared" + suffix, [] {
+        return std::make_shared<resource>();
+    });
+    measure_dead_control_block<resource>(result, "make_unique_extendable" + suffix);
+}
+
+std::vector<measurement> measure() {
+    std::vector<measurement> result;
+    result.push_back({"handle/unique_extendable_ptr", sizeof(unique_extendable_ptr<payload<1>>)});
+    result.push_back({"handle/weak_extender", sizeof(weak_extender<payload<1>>)});
+    result.push_back({"handle/scoped_extender", sizeof(scoped_extender<payload<1>>)});
+    result.push_back({"handle/pinned_extender", sizeof(pinned_extender<payload<1>>)});
+
+    measure_size<1>(result);
+    measure_size<8>(result);
+    measure_size<64>(result);
+    measure_size<256>(result);
+    measure_size<4096>(result);
+    return result;
+}
+
+std::map<std::string, std::uint64_t> read_baseline(const char* path, bool& ok) {
+    std::map<std::string, std::uint64_t> result;
+    std::ifstream file(path);
+    ok = static_cast<bool>(file);
+
+    std::string name;
+    std::uint64_t bytes;
+    while (file >> name >> bytes) {
+        result[name] = bytes;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* check = nullptr;
+    const char* write = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--check=", 8) == 0) {
+            check = argv[i] + 8;
+        } else if (std::strncmp(argv[i], "--write-baseline=", 17) == 0) {
+            write = argv[i] + 17;
+        } else {
+            std::fprintf(stderr, "usage: %s [--check=FILE] [--write-baseline=FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const auto measurements = measure();
+    for (const auto& measurement : measurements) {
+        std::printf("%-56s %8llu\n", measurement.name.c_str(), static_cast<unsigned long long>(measurement.bytes));
+    }
+
+    if (write != nullptr) {
+        std::ofstream file(write);
+        for (const auto& measurement : measurements) {
+            file << measurement.name << " " << measurement.bytes << "\n";
+        }
+        if (!file) {
+            std::fprintf(stderr, "could not write %s\n", write);
+            return 1;
+        }
+    }
+
+    if (check != nullptr) {
+        bool ok = false;
+        const auto baseline = read_baseline(check, ok);
+        if (!ok) {
+            std::fprintf(stderr, "could not read %s\n", check);
+            return 1;
+        }
+
+        int regressions = 0;
+        for (const auto& measurement : measurements) {
+            const auto found = baseline.find(measurement.name);
+            if (found != baseline.end() && measurement.bytes > found->second) {
+                std::fprintf(stderr, "footprint regression: %s is %llu, baseline %llu\n",
+                    measurement.name.c_str(),
+                    static_cast<unsigned long long>(measurement.bytes),
+                    static_cast<unsigned long long>(found->second));
+                ++regressions;
+            }
+        }
+        if (regressions != 0) {
+            return 1;
+        }
+        std::printf("no footprint regressions against %s\n", check);
+    }
+    return 0;
+}
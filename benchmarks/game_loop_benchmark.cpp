@@ -0,0 +1,292 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "extendable_histogram.h"
+#include "extendable_unique_ownership.h"
+#include "perf_counters.h"
+
+/**
+ * End-to-end workload modelled after a game: a simulation thread spawns and
+ * despawns entities every frame while reader threads (jobs) lock
+ * weak_extender-s to the entities to read or modify them.
+ *
+ * Reports frame time percentiles of the simulation thread, lock throughput
+ * of the readers and the delay between unique_extendable_ptr::reset() and
+ * the destruction of an entity. With --perf-counters also reports hardware
+ * events per frame and per lock.
+ */
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock_type::now().time_since_epoch()).count();
+}
+
+struct options {
+    std::size_t entities = 10000;
+    std::size_t churn = 1000;
+    std::size_t readers = 4;
+    std::size_t frames = 600;
+    /**
+     * @brief Share of reader operations that only read the entity, the rest
+     * modify it
+     */
+    double read_ratio = 0.9;
+    std::int64_t hold_ns = 200;
+    bool perf_counters = false;
+};
+
+latency_histogram destruction_delay_ns;
+
+struct entity {
+    ~entity() {
+        const auto reset_time = reset_time_ns.load(std::memory_order_relaxed);
+        if (reset_time != 0) {
+            destruction_delay_ns.record(static_cast<std::uint64_t>(now_ns() - reset_time));
+        }
+    }
+
+    std::atomic<std::int64_t> position{0};
+    std::atomic<std::int64_t> health{100};
+    /**
+     * @brief Set by the simulation thread right before the owner is reset
+     */
+    std::atomic<std::int64_t> reset_time_ns{0};
+};
+
+using entity_directory = std::vector<weak_extender<entity>>;
+
+volatile std::int64_t sink;
+
+void benchmark_sink(std::int64_t value) {
+    sink = value;
+}
+
+void spin_for(std::int64_t nanoseconds) {
+    const auto until = now_ns() + nanoseconds;
+    while (now_ns() < until) {}
+}
+
+void despawn(unique_extendable_ptr<entity>& owner) {
+    owner->reset_time_ns.store(now_ns(), std::memory_order_relaxed);
+    owner.reset();
+}
+
+struct reader_result {
+    std::uint64_t locks = 0;
+    std::uint64_t hits = 0;
+    perf_counter_values events;
+};
+
+void run_reader(
+    const options& options,
+    const std::shared_ptr<const entity_directory>& published,
+    const std::atomic<bool>& stopping,
+    unsigned seed,
+    reader_result& result) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> operation(0.0, 1.0);
+
+    std::unique_ptr<perf_counter_group> counters;
+    if (options.perf_counters) {
+        counters = std::make_unique<perf_counter_group>();
+        counters->start();
+    }
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        const auto directory = std::atomic_load(&published);
+        std::uniform_int_distribution<std::size_t> index(0, directory->size() - 1);
+
+        // a batch of operations per directory snapshot, like a job would do
+        for (int i = 0; i < 256; ++i) {
+            const auto& scoped = (*directory)[index(random)].lock();
+            ++result.locks;
+            if (scoped.empty()) {
+                continue;
+            }
+            ++result.hits;
+            if (operation(random) < options.read_ratio) {
+                benchmark_sink(scoped->position.load(std::memory_order_relaxed));
+            } else {
+                scoped->health.fetch_sub(1, std::memory_order_relaxed);
+            }
+            if (options.hold_ns > 0) {
+                spin_for(options.hold_ns);
+            }
+        }
+    }
+
+    if (counters != nullptr) {
+        counters->stop();
+        result.events = counters->read();
+    }
+}
+
+std::shared_ptr<const entity_directory> publish(const std::vector<unique_extendable_ptr<entity>>& owners) {
+    auto directory = std::make_shared<entity_directory>();
+    directory->reserve(owners.size());
+    for (const auto& owner : owners) {
+        directory->emplace_back(owner);
+    }
+    return directory;
+}
+
+void print_histogram(const char* name, const histogram_snapshot& histogram) {
+    std::printf("%-22s p50 %9.1f us  p90 %9.1f us  p99 %9.1f us  p99.9 %9.1f us  max %9.1f us  (%llu samples)\n",
+        name,
+        histogram.percentile(50) / 1000.0,
+        histogram.percentile(90) / 1000.0,
+        histogram.percentile(99) / 1000.0,
+        histogram.percentile(99.9) / 1000.0,
+        histogram.max / 1000.0,
+        static_cast<unsigned long long>(histogram.count));
+}
+
+void print_events(const char* name, const perf_counter_values& events, std::uint64_t operations) {
+    std::printf("%-22s", name);
+    bool any = false;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(perf_event::count); ++i) {
+        const auto event = static_cast<perf_event>(i);
+        if (events.has(event) && operations != 0) {
+            std::printf(" %s %.2f", perf_event_name(event),
+                static_cast<double>(events[event]) / static_cast<double>(operations));
+            any = true;
+        }
+    }
+    std::printf(any ? "\n" : " hardware counters unavailable\n");
+}
+
+bool parse(int argc, char** argv, options& result) {
+    for (int i = 1; i < argc; ++i) {
+        const char* argument = argv[i];
+        if (std::strcmp(argument, "--perf-counters") == 0) {
+            result.perf_counters = true;
+            continue;
+        }
+        const char* value = std::strchr(argument, '=');
+        if (value == nullptr) {
+            return false;
+        }
+        ++value;
+        if (std::strncmp(argument, "--entities=", 11) == 0) {
+            result.entities = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--churn=", 8) == 0) {
+            result.churn = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--readers=", 10) == 0) {
+            result.readers = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--frames=", 9) == 0) {
+            result.frames = std::strtoull(value, nullptr, 10);
+        } else if (std::strncmp(argument, "--read-ratio=", 13) == 0) {
+            result.read_ratio = std::strtod(value, nullptr);
+        } else if (std::strncmp(argument, "--hold-ns=", 10) == 0) {
+            result.hold_ns = std::strtoll(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return result.entities != 0 && result.churn <= result.entities;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr,
+            "usage: %s [--entities=N] [--churn=N per frame] [--readers=N] [--frames=N]"
+            " [--read-ratio=0..1] [--hold-ns=N] [--perf-counters]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<unique_extendable_ptr<entity>> owners;
+    for (std::size_t i = 0; i < options.entities; ++i) {
+        owners.push_back(make_unique_extendable<entity>());
+    }
+    auto published = publish(owners);
+
+    std::atomic<bool> stopping{false};
+    std::vector<reader_result> results(options.readers);
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < options.readers; ++i) {
+        readers.emplace_back([&, i] {
+            run_reader(options, published, stopping, static_cast<unsigned>(i + 1), results[i]);
+        });
+    }
+
+    std::mt19937 random(0);
+    std::uniform_int_distribution<std::size_t> index(0, options.entities - 1);
+    latency_histogram frame_time_ns;
+
+    std::unique_ptr<perf_counter_group> counters;
+    if (options.perf_counters) {
+        counters = std::make_unique<perf_counter_group>();
+        counters->start();
+    }
+
+    const auto started = now_ns();
+    for (std::size_t frame = 0; frame < options.frames; ++frame) {
+        const auto frame_start = now_ns();
+
+        for (std::size_t i = 0; i < options.churn; ++i) {
+            auto& owner = owners[index(random)];
+            despawn(owner);
+            owner = make_unique_extendable<entity>();
+        }
+        for (const auto& owner : owners) {
+            owner->position.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::atomic_store(&published, publish(owners));
+
+        frame_time_ns.record(static_cast<std::uint64_t>(now_ns() - frame_start));
+    }
+    const auto elapsed_s = static_cast<double>(now_ns() - started) / 1e9;
+    perf_counter_values simulation_events;
+    if (counters != nullptr) {
+        counters->stop();
+        simulation_events = counters->read();
+    }
+
+    stopping.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    for (auto& owner : owners) {
+        despawn(owner);
+    }
+
+    reader_result total;
+    for (const auto& result : results) {
+        total.locks += result.locks;
+        total.hits += result.hits;
+        for (std::size_t i = 0; i < total.events.values.size(); ++i) {
+            total.events.values[i] += result.events.values[i];
+            total.events.available[i] = total.events.available[i] || result.events.available[i];
+        }
+    }
+
+    std::printf("entities %zu, churn %zu/frame, readers %zu, frames %zu, read ratio %.2f, hold %lld ns\n",
+        options.entities, options.churn, options.readers, options.frames,
+        options.read_ratio, static_cast<long long>(options.hold_ns));
+    print_histogram("frame time", frame_time_ns.snapshot());
+    print_histogram("destruction delay", destruction_delay_ns.snapshot());
+    std::printf("%-22s %.2f M/s, %.2f%% hits\n",
+        "lock throughput",
+        static_cast<double>(total.locks) / elapsed_s / 1e6,
+        total.locks != 0 ? 100.0 * static_cast<double>(total.hits) / static_cast<double>(total.locks) : 0.0);
+    if (options.perf_counters) {
+        print_events("events per frame", simulation_events, options.frames);
+        print_events("events per lock", total.events, total.locks);
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "allocation_counter.h"
+#include "extendable_group.h"
+#include "extendable_registry.h"
+#include "extendable_unique_ownership.h"
+#include "perf_region.h"
+
+/**
+ * Every case is measured for the smart pointers of this module and for plain
+ * std::shared_ptr/std::weak_ptr which they wrap, so that the cost of the
+ * wrapper can be read directly from neighbouring lines of the report.
+ *
+ * With EXTENDABLE_PERF_COUNTERS=1 in the environment every case also reports
+ * hardware events (cycles, instructions, cache misses) per operation, see
+ * perf_region.
+ */
+
+namespace {
+
+struct payload {
+    explicit payload(int value) : value(value) {}
+    int value;
+};
+
+constexpr int max_threads = 64;
+
+void BM_extendable_create_destroy(benchmark::State& state) {
+    perf_region region(state);
+    for (auto _ : state) {
+        auto unique = make_unique_extendable<payload>(1);
+        benchmark::DoNotOptimize(unique.get());
+        unique.reset();
+    }
+}
+BENCHMARK(BM_extendable_create_destroy);
+
+void BM_shared_create_destroy(benchmark::State& state) {
+    perf_region region(state);
+    for (auto _ : state) {
+        auto shared = std::make_shared<payload>(1);
+        benchmark::DoNotOptimize(shared.get());
+        shared.reset();
+    }
+}
+BENCHMARK(BM_shared_create_destroy);
+
+// a batch of resources that die together, owned one by one and as a group,
+// only the teardown is timed
+void BM_extendable_batch_reset_all(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    perf_region region(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<unique_extendable_ptr<payload>> batch;
+        batch.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.push_back(make_unique_extendable<payload>(1));
+        }
+        state.ResumeTiming();
+        reset_all(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_extendable_batch_reset_all)->Arg(1024);
+
+void BM_extendable_batch_group_reset(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    perf_region region(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<payload>> resources;
+        resources.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            resources.push_back(std::make_unique<payload>(1));
+        }
+        extendable_group<payload> group(std::move(resources));
+        state.ResumeTiming();
+        group.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_extendable_batch_group_reset)->Arg(1024);
+
+void BM_extendable_lock(benchmark::State& state) {
+    auto unique = make_unique_extendable<payload>(1);
+    weak_extender<payload> weak(unique);
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = weak.lock();
+        benchmark::DoNotOptimize(scoped.get());
+    }
+}
+BENCHMARK(BM_extendable_lock);
+
+void BM_extendable_scope_lock(benchmark::State& state) {
+    auto unique = make_unique_extendable<payload>(1);
+    weak_extender<payload> weak(unique);
+    const auto& scope = extension_scope::open();
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = weak.lock(scope);
+        benchmark::DoNotOptimize(scoped.get());
+    }
+}
+BENCHMARK(BM_extendable_scope_lock);
+
+void BM_extendable_nested_lock(benchmark::State& state) {
+    auto unique = make_unique_extendable<payload>(1);
+    weak_extender<payload> weak(unique);
+    const auto& outer = weak.lock();
+    benchmark::DoNotOptimize(outer.get());
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = weak.lock();
+        benchmark::DoNotOptimize(scoped.get());
+    }
+}
+BENCHMARK(BM_extendable_nested_lock);
+
+void BM_shared_lock(benchmark::State& state) {
+    auto shared = std::make_shared<payload>(1);
+    std::weak_ptr<payload> weak(shared);
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& locked = weak.lock();
+        benchmark::DoNotOptimize(locked.get());
+    }
+}
+BENCHMARK(BM_shared_lock);
+
+// objects shared by all the threads of the contended cases
+unique_extendable_ptr<payload> contended_unique = make_unique_extendable<payload>(1);
+const weak_extender<payload> contended_extender(contended_unique);
+std::shared_ptr<payload> contended_shared = std::make_shared<payload>(1);
+const std::weak_ptr<payload> contended_weak(contended_shared);
+
+void BM_extendable_contended_lock(benchmark::State& state) {
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = contended_extender.lock();
+        benchmark::DoNotOptimize(scoped.get());
+    }
+}
+BENCHMARK(BM_extendable_contended_lock)->ThreadRange(1, max_threads)->UseRealTime();
+
+void BM_extendable_contended_scope_lock(benchmark::State& state) {
+    const auto& scope = extension_scope::open();
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = contended_extender.lock(scope);
+        benchmark::DoNotOptimize(scoped.get());
+    }
+}
+BENCHMARK(BM_extendable_contended_scope_lock)->ThreadRange(1, max_threads)->UseRealTime();
+
+void BM_shared_contended_lock(benchmark::State& state) {
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& locked = contended_weak.lock();
+        benchmark::DoNotOptimize(locked.get());
+    }
+}
+BENCHMARK(BM_shared_contended_lock)->ThreadRange(1, max_threads)->UseRealTime();
+
+extendable_registry<payload>& contended_registry() {
+    static extendable_registry<payload> registry;
+    static const bool published = [] {
+        registry.insert(make_unique_extendable<payload>(1));
+        registry.publish();
+        return true;
+    }();
+    (void)published;
+    return registry;
+}
+
+void BM_extendable_contended_registry_read(benchmark::State& state) {
+    const auto& registry = contended_registry();
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& snapshot = registry.read();
+        benchmark::DoNotOptimize(snapshot.begin());
+    }
+}
+BENCHMARK(BM_extendable_contended_registry_read)->ThreadRange(1, max_threads)->UseRealTime();
+
+void BM_extendable_failed_lock(benchmark::State& state) {
+    auto unique = make_unique_extendable<payload>(1);
+    weak_extender<payload> weak(unique);
+    unique.reset();
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& scoped = weak.lock();
+        benchmark::DoNotOptimize(scoped.empty());
+    }
+}
+BENCHMARK(BM_extendable_failed_lock);
+
+void BM_shared_failed_lock(benchmark::State& state) {
+    auto shared = std::make_shared<payload>(1);
+    std::weak_ptr<payload> weak(shared);
+    shared.reset();
+    perf_region region(state);
+    for (auto _ : state) {
+        const auto& locked = weak.lock();
+        benchmark::DoNotOptimize(locked.get());
+    }
+}
+BENCHMARK(BM_shared_failed_lock);
+
+void BM_extendable_handle_copy(benchmark::State& state) {
+    auto unique = make_unique_extendable<payload>(1);
+    weak_extender<payload> weak(unique);
+    perf_region region(state);
+    for (auto _ : state) {
+        weak_extender<payload> copy(weak);
+        benchmark::DoNotOptimize(&copy);
+    }
+}
+BENCHMARK(BM_extendable_handle_copy);
+
+void BM_shared_handle_copy(benchmark::State& state) {
+    auto shared = std::make_shared<payload>(1);
+    std::weak_ptr<payload> weak(shared);
+    perf_region region(state);
+    for (auto _ : state) {
+        std::weak_ptr<payload> copy(weak);
+        benchmark::DoNotOptimize(&copy);
+    }
+}
+BENCHMARK(BM_shared_handle_copy);
+
+/**
+ * @brief Reports heap bytes and allocations per object, plus the size of the
+ * owning and the weak handles
+ */
+template <typename Owner, typename Weak, typename Create>
+void measure_memory(benchmark::State& state, Create create) {
+    constexpr std::size_t object_count = 1024;
+    allocation_counter allocated;
+
+    for (auto _ : state) {
+        std::vector<Owner> owners;
+        owners.reserve(object_count);
+
+        const auto before = allocation_counter::this_thread();
+        for (std::size_t i = 0; i < object_count; ++i) {
+            owners.push_back(create());
+        }
+        allocated = allocation_counter::this_thread() - before;
+        benchmark::DoNotOptimize(owners.data());
+    }
+
+    state.counters["heap_bytes_per_object"] = static_cast<double>(allocated.bytes) / object_count;
+    state.counters["allocations_per_object"] = static_cast<double>(allocated.allocations) / object_count;
+    state.counters["owner_handle_bytes"] = sizeof(Owner);
+    state.counters["weak_handle_bytes"] = sizeof(Weak);
+}
+
+void BM_extendable_memory_per_object(benchmark::State& state) {
+    measure_memory<unique_extendable_ptr<payload>, weak_extender<payload>>(state, [] {
+        return make_unique_extendable<payload>(1);
+    });
+}
+BENCHMARK(BM_extendable_memory_per_object);
+
+void BM_shared_memory_per_object(benchmark::State& state) {
+    measure_memory<std::shared_ptr<payload>, std::weak_ptr<payload>>(state, [] {
+        return std::make_shared<payload>(1);
+    });
+}
+BENCHMARK(BM_shared_memory_per_object);
+
+} // namespace
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "extendable_parallel.h"
+#include "extendable_unique_ownership.h"
+
+/**
+ * A per-frame update of every object of a storage: the serial loops either
+ * lock every weak_extender on its own or borrow them inside an extension_scope
+ * per chunk the way parallel_for_each does, parallel_for_each splits the
+ * storage over a pool of the given number of workers (plus the calling
+ * thread). The items per second of the parallel cases divided by the ones of
+ * BM_serial_scope_for_each is the scaling, which should stay close to the
+ * number of threads as long as there are cores for them. BM_serial_for_each
+ * shows what the scope locks save on their own.
+ */
+
+namespace {
+
+constexpr std::size_t object_count = 1 << 16;
+constexpr std::size_t chunk_size = 1024;
+
+struct entity {
+    float position = 0.0f;
+    float velocity = 1.0f;
+};
+
+/**
+ * @brief A few hundred cycles of work, so that the update is not bound by
+ * the memory bandwidth alone
+ */
+void update(entity& updated) {
+    for (int step = 0; step < 16; ++step) {
+        updated.velocity = std::sqrt(updated.velocity * updated.velocity + 0.01f);
+        updated.position += updated.velocity * 0.016f;
+    }
+}
+
+struct storage {
+    storage() {
+        owners.reserve(object_count);
+        extenders.reserve(object_count);
+        for (std::size_t i = 0; i < object_count; ++i) {
+            owners.push_back(make_unique_extendable<entity>());
+            extenders.emplace_back(owners.back());
+        }
+    }
+
+    std::vector<unique_extendable_ptr<entity>> owners;
+    std::vector<weak_extender<entity>> extenders;
+};
+
+void BM_serial_for_each(benchmark::State& state) {
+    storage objects;
+    for (auto _ : state) {
+        for (const auto& extender : objects.extenders) {
+            const auto& scoped = extender.lock();
+            if (!scoped.empty()) {
+                update(*scoped.get());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * object_count);
+}
+BENCHMARK(BM_serial_for_each)->UseRealTime();
+
+void BM_serial_scope_for_each(benchmark::State& state) {
+    storage objects;
+    for (auto _ : state) {
+        for (std::size_t first = 0; first < object_count; first += chunk_size) {
+            const auto& scope = extension_scope::open();
+            for (std::size_t i = first; i < first + chunk_size; ++i) {
+                const auto& scoped = objects.extenders[i].lock(scope);
+                if (!scoped.empty()) {
+                    update(*scoped.get());
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * object_count);
+}
+BENCHMARK(BM_serial_scope_for_each)->UseRealTime();
+
+void BM_parallel_for_each(benchmark::State& state) {
+    storage objects;
+    // the calling thread takes part as well
+    work_stealing_pool pool(static_cast<std::size_t>(state.range(0)) - 1);
+    for (auto _ : state) {
+        parallel_for_each(
+            pool, objects.extenders, [](entity& updated) { update(updated); }, chunk_size);
+    }
+    state.SetItemsProcessed(state.iterations() * object_count);
+}
+BENCHMARK(BM_parallel_for_each)
+    ->RangeMultiplier(2)
+    ->Range(2, static_cast<int>(std::max(2u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
+
+} // namespace
@@ -0,0 +1,142 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+namespace {
+
+#if defined(__linux__)
+
+struct event_config {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t cache_read_miss(std::uint64_t cache) {
+    return cache
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+const event_config configs[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1I)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+};
+
+static_assert(sizeof(configs) / sizeof(configs[0]) == static_cast<std::size_t>(perf_event::count),
+    "every perf_event needs a config");
+
+int open_event(const event_config& config, int group) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = config.type;
+    attributes.config = config.config;
+    attributes.disabled = group == -1 ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // calling thread, any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, group, 0));
+}
+
+#endif
+
+} // namespace
+
+const char* perf_event_name(perf_event event) {
+    switch (event) {
+    case perf_event::cycles: return "cycles";
+    case perf_event::instructions: return "instructions";
+    case perf_event::cache_references: return "cache_references";
+    case perf_event::cache_misses: return "cache_misses";
+    case perf_event::l1d_read_misses: return "l1d_read_misses";
+    case perf_event::l1i_read_misses: return "l1i_read_misses";
+    case perf_event::llc_read_misses: return "llc_read_misses";
+    case perf_event::count: break;
+    }
+    return "unknown";
+}
+
+std::uint64_t perf_counter_values::operator[](perf_event event) const {
+    return values[static_cast<std::size_t>(event)];
+}
+
+bool perf_counter_values::has(perf_event event) const {
+    return available[static_cast<std::size_t>(event)];
+}
+
+perf_counter_group::perf_counter_group() {
+    descriptors.fill(closed);
+#if defined(__linux__)
+    for (std::size_t i = 0; i < descriptors.size(); ++i) {
+        descriptors[i] = open_event(configs[i], leader);
+        if (leader == closed && descriptors[i] != closed) {
+            leader = descriptors[i];
+        }
+    }
+#endif
+}
+
+perf_counter_group::~perf_counter_group() {
+#if defined(__linux__)
+    for (auto descriptor : descriptors) {
+        if (descriptor != closed) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool perf_counter_group::available() const {
+    return leader != closed;
+}
+
+void perf_counter_group::start() {
+#if defined(__linux__)
+    if (available()) {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void perf_counter_group::stop() {
+#if defined(__linux__)
+    if (available()) {
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+perf_counter_values perf_counter_group::read() const {
+    perf_counter_values result;
+#if defined(__linux__)
+    for (std::size_t i = 0; i < descriptors.size(); ++i) {
+        if (descriptors[i] == closed) {
+            continue;
+        }
+        std::uint64_t data[3] = {0, 0, 0}; // value, time enabled, time running
+        if (::read(descriptors[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;
+        }
+        // the counter was multiplexed with other events for part of the time
+        const auto scaled = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        result.values[i] = static_cast<std::uint64_t>(scaled);
+        result.available[i] = true;
+    }
+#endif
+    return result;
+}
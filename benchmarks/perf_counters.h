@@ -0,0 +1,70 @@
+#ifndef _PERF_COUNTERS_
+#define _PERF_COUNTERS_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hardware events counted by @see perf_counter_group
+ */
+enum class perf_event : std::size_t {
+    cycles,
+    instructions,
+    cache_references,
+    cache_misses,
+    l1d_read_misses,
+    l1i_read_misses,
+    llc_read_misses,
+    count
+};
+
+const char* perf_event_name(perf_event);
+
+/**
+ * @brief Values read from a @see perf_counter_group, scaled for multiplexing
+ */
+struct perf_counter_values {
+    std::array<std::uint64_t, static_cast<std::size_t>(perf_event::count)> values{};
+    std::array<bool, static_cast<std::size_t>(perf_event::count)> available{};
+
+    std::uint64_t operator[](perf_event event) const;
+    bool has(perf_event event) const;
+};
+
+/**
+ * @brief Hardware performance counters of the calling thread, read through
+ * Linux perf_event_open()
+ * @details Counters that can not be opened (no PMU access in containers and
+ * virtual machines, perf_event_paranoid restrictions, non-Linux systems) are
+ * reported as unavailable instead of failing, so the benchmarks keep working
+ * and simply report fewer numbers.
+ */
+class perf_counter_group {
+public:
+    perf_counter_group();
+    ~perf_counter_group();
+
+    perf_counter_group(const perf_counter_group&) = delete;
+    perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+    /**
+     * @brief Whether at least one counter could be opened
+     */
+    bool available() const;
+
+    /**
+     * @brief Resets and starts all the counters
+     */
+    void start();
+    void stop();
+    perf_counter_values read() const;
+
+private:
+    static constexpr int closed = -1;
+
+    std::array<int, static_cast<std::size_t>(perf_event::count)> descriptors;
+    int leader = closed;
+};
+
+#endif // _PERF_COUNTERS_
@@ -0,0 +1,59 @@
+#ifndef _PERF_REGION_
+#define _PERF_REGION_
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.h"
+
+/**
+ * @brief Counts hardware events from its construction till its destruction
+ * in the calling thread and reports them per iteration of the benchmark
+ * @details Enabled by setting the EXTENDABLE_PERF_COUNTERS environment
+ * variable to 1. Does nothing when disabled or when no counter is available.
+ * In multi-threaded benchmarks every thread counts its own events and the
+ * reported value is the sum over all threads divided by the total number of
+ * iterations.
+ */
+class perf_region {
+public:
+    explicit perf_region(benchmark::State& state)
+        : state(state) {
+        if (enabled()) {
+            counters = std::make_unique<perf_counter_group>();
+            counters->start();
+        }
+    }
+
+    ~perf_region() {
+        if (counters == nullptr) {
+            return;
+        }
+        counters->stop();
+        const auto values = counters->read();
+        for (std::size_t i = 0; i < static_cast<std::size_t>(perf_event::count); ++i) {
+            const auto event = static_cast<perf_event>(i);
+            if (values.has(event)) {
+                state.counters[std::string(perf_event_name(event)) + "/op"] = benchmark::Counter(
+                    static_cast<double>(values[event]), benchmark::Counter::kAvgIterations);
+            }
+        }
+    }
+
+    perf_region(const perf_region&) = delete;
+    perf_region& operator=(const perf_region&) = delete;
+
+    static bool enabled() {
+        const char* variable = std::getenv("EXTENDABLE_PERF_COUNTERS");
+        return variable != nullptr && variable[0] == '1';
+    }
+
+private:
+    benchmark::State& state;
+    std::unique_ptr<perf_counter_group> counters;
+};
+
+#endif // _PERF_REGION_
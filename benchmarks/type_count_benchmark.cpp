@@ -0,0 +1,155 @@
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "extendable_unique_ownership.h"
+#include "perf_region.h"
+
+/**
+ * Every case runs its operation round-robin over objects of type_count
+ * distinct types, so that the instantiated code of every type is on the hot
+ * path the same way as in a program with hundreds of object types. Compared
+ * to the single-type cases of ownership_benchmark, the difference is the cost
+ * of the per-type code: instruction cache misses (see l1i_read_misses/op with
+ * EXTENDABLE_PERF_COUNTERS=1) and, with the code_size target, the size of the
+ * binary.
+ */
+
+namespace {
+
+constexpr std::size_t type_count = 256;
+
+template <std::size_t Index>
+struct object {
+    int value = static_cast<int>(Index);
+};
+
+struct typed_operations {
+    void (*create_destroy)();
+    int (*lock)(const void* extender);
+};
+
+template <std::size_t Index>
+void extendable_create_destroy() {
+    auto unique = make_unique_extendable<object<Index>>();
+    benchmark::DoNotOptimize(unique.get());
+    unique.reset();
+}
+
+template <std::size_t Index>
+int extendable_lock(const void* extender) {
+    const auto& scoped = static_cast<const weak_extender<object<Index>>*>(extender)->lock();
+    return !scoped.empty() ? scoped->value : 0;
+}
+
+template <std::size_t Index>
+void shared_create_destroy() {
+    auto shared = std::make_shared<object<Index>>();
+    benchmark::DoNotOptimize(shared.get());
+    shared.reset();
+}
+
+template <std::size_t Index>
+int shared_lock(const void* weak) {
+    const auto& locked = static_cast<const std::weak_ptr<object<Index>>*>(weak)->lock();
+    return locked != nullptr ? locked->value : 0;
+}
+
+/**
+ * @brief Objects of every type with type-erased access to their typed code
+ */
+class extendable_objects {
+public:
+    extendable_objects()
+        : extendable_objects(std::make_index_sequence<type_count>()) {}
+
+    std::vector<typed_operations> operations;
+    std::vector<std::shared_ptr<void>> owners;
+    std::vector<std::shared_ptr<void>> extenders;
+
+private:
+    template <std::size_t... Indices>
+    explicit extendable_objects(std::index_sequence<Indices...>) {
+        (add<Indices>(), ...);
+    }
+
+    template <std::size_t Index>
+    void add() {
+        auto owner = std::make_shared<unique_extendable_ptr<object<Index>>>(
+            make_unique_extendable<object<Index>>());
+        extenders.push_back(std::make_shared<weak_extender<object<Index>>>(*owner));
+        owners.push_back(std::move(owner));
+        operations.push_back({&extendable_create_destroy<Index>, &extendable_lock<Index>});
+    }
+};
+
+class shared_objects {
+public:
+    shared_objects()
+        : shared_objects(std::make_index_sequence<type_count>()) {}
+
+    std::vector<typed_operations> operations;
+    std::vector<std::shared_ptr<void>> owners;
+    std::vector<std::shared_ptr<void>> extenders;
+
+private:
+    template <std::size_t... Indices>
+    explicit shared_objects(std::index_sequence<Indices...>) {
+        (add<Indices>(), ...);
+    }
+
+    template <std::size_t Index>
+    void add() {
+        auto owner = std::make_shared<object<Index>>();
+        extenders.push_back(std::make_shared<std::weak_ptr<object<Index>>>(owner));
+        owners.push_back(std::move(owner));
+        operations.push_back({&shared_create_destroy<Index>, &shared_lock<Index>});
+    }
+};
+
+template <typename Objects>
+void create_destroy(benchmark::State& state) {
+    Objects objects;
+    std::size_t next = 0;
+    perf_region region(state);
+    for (auto _ : state) {
+        objects.operations[next].create_destroy();
+        next = next + 1 != type_count ? next + 1 : 0;
+    }
+}
+
+template <typename Objects>
+void lock(benchmark::State& state) {
+    Objects objects;
+    std::size_t next = 0;
+    perf_region region(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(objects.operations[next].lock(objects.extenders[next].get()));
+        next = next + 1 != type_count ? next + 1 : 0;
+    }
+}
+
+void BM_extendable_many_types_create_destroy(benchmark::State& state) {
+    create_destroy<extendable_objects>(state);
+}
+BENCHMARK(BM_extendable_many_types_create_destroy);
+
+void BM_shared_many_types_create_destroy(benchmark::State& state) {
+    create_destroy<shared_objects>(state);
+}
+BENCHMARK(BM_shared_many_types_create_destroy);
+
+void BM_extendable_many_types_lock(benchmark::State& state) {
+    lock<extendable_objects>(state);
+}
+BENCHMARK(BM_extendable_many_types_lock);
+
+void BM_shared_many_types_lock(benchmark::State& state) {
+    lock<shared_objects>(state);
+}
+BENCHMARK(BM_shared_many_types_lock);
+
+} // namespace
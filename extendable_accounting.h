@@ -0,0 +1,90 @@
+#ifndef _EXTENDABLE_ACCOUNTING_
+#define _EXTENDABLE_ACCOUNTING_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Values of the @see extendable_accounting gauges for a single type
+ */
+struct extendable_accounting_snapshot {
+    /**
+     * @brief unique_extendable_ptr-s that own a resource
+     */
+    std::int64_t live_owners = 0;
+    /**
+     * @brief Resources that were not handed to the destruction policy yet,
+     * including the ones that outlive their owners thanks to scoped_extender-s
+     */
+    std::int64_t live_resources = 0;
+    /**
+     * @brief Allocated control blocks, alive or dead
+     */
+    std::int64_t control_blocks = 0;
+    /**
+     * @brief Control blocks whose last strong reference is gone but which are
+     * still kept allocated by weak_extender-s
+     * @details Counted separately from live_resources, an @see extendable_group
+     * shares a single control block among all of its resources.
+     */
+    std::int64_t dead_control_blocks = 0;
+    std::int64_t control_block_bytes = 0;
+    /**
+     * @brief sizeof(T) times live_resources, does not include memory owned by
+     * the resources themselves
+     */
+    std::int64_t resource_bytes = 0;
+};
+
+/**
+ * @brief Per-type gauges of live objects and of the memory they occupy,
+ * enabled by EXTENDABLE_ENABLE_ACCOUNTING
+ * @details Maintained from make_unique_extendable/reset() and from the
+ * allocator of the control blocks, so that leaks and control blocks kept
+ * alive by forgotten weak_extender-s can be found without a heap profiler.
+ *
+ * Every thread updates its own cache-line sized shard of gauges with plain
+ * relaxed stores. A single shard may hold negative values (a resource may be
+ * created in one thread and destroyed in another), their sum is exact.
+ *
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+class extendable_accounting {
+public:
+    static extendable_accounting_snapshot snapshot();
+
+    static void add_owners(std::int64_t);
+    static void add_resources(std::int64_t);
+    static void add_control_blocks(std::int64_t count, std::int64_t bytes);
+    static void add_dead_control_blocks(std::int64_t);
+
+private:
+    struct alignas(64) shard {
+        std::atomic<std::int64_t> live_owners{0};
+        std::atomic<std::int64_t> live_resources{0};
+        std::atomic<std::int64_t> control_blocks{0};
+        std::atomic<std::int64_t> dead_control_blocks{0};
+        std::atomic<std::int64_t> control_block_bytes{0};
+    };
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<shard>> shards;
+    };
+
+    static registry& all_shards();
+    static shard& this_thread_shard();
+    /**
+     * @brief Update by the only thread that writes the gauge
+     */
+    static void add(std::atomic<std::int64_t>&, std::int64_t);
+};
+
+#include "extendable_accounting_impl.h"
+
+#endif // _EXTENDABLE_ACCOUNTING_
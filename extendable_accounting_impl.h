@@ -0,0 +1,67 @@
+#ifndef _EXTENDABLE_ACCOUNTING_IMPL_
+#define _EXTENDABLE_ACCOUNTING_IMPL_
+
+template <typename T>
+/*static*/ extendable_accounting_snapshot extendable_accounting<T>::snapshot() {
+    extendable_accounting_snapshot result;
+    {
+        auto& registry = all_shards();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& shard : registry.shards) {
+            result.live_owners += shard->live_owners.load(std::memory_order_relaxed);
+            result.live_resources += shard->live_resources.load(std::memory_order_relaxed);
+            result.control_blocks += shard->control_blocks.load(std::memory_order_relaxed);
+            result.dead_control_blocks += shard->dead_control_blocks.load(std::memory_order_relaxed);
+            result.control_block_bytes += shard->control_block_bytes.load(std::memory_order_relaxed);
+        }
+    }
+    result.resource_bytes = result.live_resources * static_cast<std::int64_t>(sizeof(T));
+    return result;
+}
+
+template <typename T>
+/*static*/ void extendable_accounting<T>::add_owners(std::int64_t count) {
+    add(this_thread_shard().live_owners, count);
+}
+
+template <typename T>
+/*static*/ void extendable_accounting<T>::add_resources(std::int64_t count) {
+    add(this_thread_shard().live_resources, count);
+}
+
+template <typename T>
+/*static*/ void extendable_accounting<T>::add_control_blocks(std::int64_t count, std::int64_t bytes) {
+    auto& shard = this_thread_shard();
+    add(shard.control_blocks, count);
+    add(shard.control_block_bytes, bytes);
+}
+
+template <typename T>
+/*static*/ void extendable_accounting<T>::add_dead_control_blocks(std::int64_t count) {
+    add(this_thread_shard().dead_control_blocks, count);
+}
+
+template <typename T>
+/*static*/ typename extendable_accounting<T>::registry& extendable_accounting<T>::all_shards() {
+    static registry instance;
+    return instance;
+}
+
+template <typename T>
+/*static*/ typename extendable_accounting<T>::shard& extendable_accounting<T>::this_thread_shard() {
+    static thread_local std::shared_ptr<shard> local = [] {
+        auto created = std::make_shared<shard>();
+        auto& registry = all_shards();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.shards.push_back(created);
+        return created;
+    }();
+    return *local;
+}
+
+template <typename T>
+/*static*/ void extendable_accounting<T>::add(std::atomic<std::int64_t>& gauge, std::int64_t value) {
+    gauge.store(gauge.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+#endif // _EXTENDABLE_ACCOUNTING_IMPL_
@@ -0,0 +1,95 @@
+#ifndef _EXTENDABLE_DESTRUCTION_BLAME_
+#define _EXTENDABLE_DESTRUCTION_BLAME_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Aggregated destruction delays caused by scoped_extender-s created at
+ * a single lock() call site and released in a single thread
+ */
+struct destruction_blame_entry {
+    const char* type_name;
+    const char* file_name;
+    const char* function_name;
+    std::uint_least32_t line;
+    std::thread::id thread;
+
+    std::uint64_t delayed_destructions = 0;
+    std::chrono::nanoseconds total_delay{0};
+    std::chrono::nanoseconds max_delay{0};
+};
+
+/**
+ * @brief Finds out who delays the destruction of resources after their
+ * owners are reset, enabled by EXTENDABLE_ENABLE_DESTRUCTION_BLAME (requires
+ * C++20)
+ * @details When a resource is destroyed by the release of the last
+ * scoped_extender rather than by unique_extendable_ptr::reset() itself, the
+ * releasing thread, the call site of the weak_extender::lock() that produced
+ * the scoped_extender and the time elapsed since the resource was marked for
+ * destruction are recorded. Records are aggregated per call site and thread.
+ *
+ * A release that leaves its reference to be dropped later keeps its call site
+ * with the reference: the reference parked for the nested scoped_extender-s
+ * of the same thread, and the one queued to the registering thread by a
+ * scoped_extender released on another thread, which is then the releasing
+ * thread.
+ *
+ * Only delayed destructions take the (mutex protected) recording path,
+ * every other lifetime event costs a thread-local store.
+ */
+class destruction_blame {
+public:
+    /**
+     * @brief Returns up to count entries with the largest total delay first
+     */
+    static std::vector<destruction_blame_entry> top_offenders(std::size_t count);
+    static void write_report(std::ostream&, std::size_t count = 10);
+    static void clear();
+
+    /**
+     * @brief Sets the call site of the scoped_extender being released by the
+     * calling thread, nullptr when the release is over
+     */
+    static void set_releasing_call_site(const std::source_location*);
+    static const std::source_location* releasing_call_site();
+    /**
+     * @brief Records a delayed destruction if the resource is being destroyed
+     * by the release of a scoped_extender in the calling thread
+     */
+    static void on_destroy(const char* type_name, std::int64_t reset_time_ns);
+
+private:
+    struct key {
+        const char* type_name;
+        const char* file_name;
+        const char* function_name;
+        std::uint_least32_t line;
+        std::thread::id thread;
+
+        bool operator==(const key&) const;
+    };
+
+    struct key_hash {
+        std::size_t operator()(const key&) const;
+    };
+
+    struct state {
+        std::mutex mutex;
+        std::unordered_map<key, destruction_blame_entry, key_hash> entries;
+    };
+
+    static state& global();
+    static const std::source_location*& this_thread_call_site();
+};
+
+#include "extendable_destruction_blame_impl.h"
+
+#endif // _EXTENDABLE_DESTRUCTION_BLAME_
@@ -0,0 +1,112 @@
+#ifndef _EXTENDABLE_DESTRUCTION_BLAME_IMPL_
+#define _EXTENDABLE_DESTRUCTION_BLAME_IMPL_
+
+#include <algorithm>
+#include <functional>
+
+inline /*static*/ std::vector<destruction_blame_entry> destruction_blame::top_offenders(std::size_t count) {
+    std::vector<destruction_blame_entry> result;
+    {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (const auto& entry : state.entries) {
+            result.push_back(entry.second);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto& left, const auto& right) {
+        return left.total_delay > right.total_delay;
+    });
+    if (result.size() > count) {
+        result.resize(count);
+    }
+    return result;
+}
+
+inline /*static*/ void destruction_blame::write_report(std::ostream& out, std::size_t count) {
+    const auto to_us = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+
+    out << "destruction delays by lock() call site and releasing thread:\n";
+    for (const auto& entry : top_offenders(count)) {
+        out << "  " << entry.type_name
+            << " locked at " << entry.file_name << ":" << entry.line << " (" << entry.function_name << ")"
+            << " released by thread " << entry.thread
+            << ": " << entry.delayed_destructions << " delayed destructions"
+            << ", total " << to_us(entry.total_delay) << " us"
+            << ", max " << to_us(entry.max_delay) << " us\n";
+    }
+}
+
+inline /*static*/ void destruction_blame::clear() {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.entries.clear();
+}
+
+inline /*static*/ void destruction_blame::set_releasing_call_site(const std::source_location* call_site) {
+    this_thread_call_site() = call_site;
+}
+
+inline /*static*/ const std::source_location* destruction_blame::releasing_call_site() {
+    return this_thread_call_site();
+}
+
+inline /*static*/ void destruction_blame::on_destroy(const char* type_name, std::int64_t reset_time_ns) {
+    const auto* call_site = releasing_call_site();
+    if (call_site == nullptr || reset_time_ns == 0) {
+        return;
+    }
+    const auto delay = std::chrono::nanoseconds(
+        std::max<std::int64_t>(instrumentation_clock_ns() - reset_time_ns, 0));
+
+    const key site{
+        type_name,
+        call_site->file_name(),
+        call_site->function_name(),
+        call_site->line(),
+        std::this_thread::get_id()
+    };
+
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto inserted = state.entries.emplace(site, destruction_blame_entry{
+        site.type_name, site.file_name, site.function_name, site.line, site.thread});
+    auto& entry = inserted.first->second;
+    ++entry.delayed_destructions;
+    entry.total_delay += delay;
+    entry.max_delay = std::max(entry.max_delay, delay);
+}
+
+inline bool destruction_blame::key::operator==(const key& other) const {
+    return type_name == other.type_name
+        && file_name == other.file_name
+        && function_name == other.function_name
+        && line == other.line
+        && thread == other.thread;
+}
+
+inline std::size_t destruction_blame::key_hash::operator()(const key& site) const {
+    auto hash = std::hash<const void*>()(site.type_name);
+    const auto combine = [&hash](std::size_t value) {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    };
+    combine(std::hash<const void*>()(site.file_name));
+    combine(std::hash<const void*>()(site.function_name));
+    combine(std::hash<std::uint_least32_t>()(site.line));
+    combine(std::hash<std::thread::id>()(site.thread));
+    return hash;
+}
+
+inline /*static*/ destruction_blame::state& destruction_blame::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ const std::source_location*& destruction_blame::this_thread_call_site() {
+    static thread_local const std::source_location* call_site = nullptr;
+    return call_site;
+}
+
+#endif // _EXTENDABLE_DESTRUCTION_BLAME_IMPL_
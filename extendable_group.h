@@ -0,0 +1,130 @@
+#ifndef _EXTENDABLE_GROUP_
+#define _EXTENDABLE_GROUP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Owns a set of resources that always die together (e.g. the objects
+ * of a level chunk) with a single control block
+ * @details Behaves like a set of @see unique_extendable_ptr-s that are reset
+ * at the same time, but the resources share one control block and one
+ * reference counter: the resource owners of all of them are allocated as a
+ * single array, a @see weak_extender to any of them aliases the control block
+ * of the group, so locking any of them extends the lifetime of the whole
+ * group.
+ *
+ * reset() marks all the resources for destruction in a single pass followed by
+ * a single fence and releases one reference instead of a sequentially
+ * consistent store, a reference counter decrement and a deallocation per
+ * resource. Every resource still has its own marked_for_destruction flag,
+ * so locking a member of a group costs exactly the same as locking
+ * a resource owned by a unique_extendable_ptr.
+ *
+ * @tparam T Type of the owned resources
+ */
+template <typename T>
+class extendable_group {
+public:
+    using element_type = T;
+
+    /**
+     * @brief Constructs an empty group that does not own anything
+     */
+    extendable_group() = default;
+    /**
+     * @brief Takes over the ownership of the resources, null ones included
+     */
+    explicit extendable_group(std::vector<std::unique_ptr<T>>);
+
+    /**
+     * @brief @see reset()
+     */
+    ~extendable_group();
+
+    extendable_group(const extendable_group&) = delete;
+    extendable_group& operator=(const extendable_group&) = delete;
+    extendable_group(extendable_group&&);
+    /**
+     * @brief Resets the currently owned resources before taking over the
+     * resources of the other group
+     */
+    extendable_group& operator=(extendable_group&&);
+
+    std::size_t size() const;
+    T* get(std::size_t index) const;
+
+    /**
+     * @brief Returns a @see weak_extender to the resource with the given index
+     */
+    weak_extender<T> extender(std::size_t index) const;
+
+    /**
+     * @brief Stops owning all the resources, each of them is destroyed once
+     * the group is no longer extended by any @see scoped_extender
+     */
+    void reset();
+
+private:
+    using resource_owner = typename unique_extendable_ptr<T>::resource_owner;
+    using strong_lifetime_link = typename unique_extendable_ptr<T>::strong_lifetime_link;
+    template <typename U>
+    using control_block_allocator = typename unique_extendable_ptr<T>::template control_block_allocator<U>;
+
+    /**
+     * @brief Deleter of the group, releases every resource the same way
+     * as the control_block_allocator of unique_extendable_ptr does
+     */
+    struct release_members {
+        std::size_t size;
+
+        void operator()(resource_owner*) const;
+    };
+
+    /**
+     * @brief Allocator of the control block of the group, also owns the
+     * array of resource owners so that it is freed together with the
+     * control block and the marked_for_destruction flags stay readable as
+     * long as any @see weak_extender refers to the group
+     */
+    template <typename U>
+    struct members_allocator {
+    public:
+        using value_type = U;
+
+        template <typename V>
+        struct rebind {
+            using other = members_allocator<V>;
+        };
+
+        members_allocator(resource_owner* members, std::size_t size);
+        template <typename V>
+        members_allocator(const members_allocator<V>&);
+
+        U* allocate(std::size_t);
+        void deallocate(U*, std::size_t);
+
+        template <typename V>
+        bool operator==(const members_allocator<V>&) const;
+        template <typename V>
+        bool operator!=(const members_allocator<V>&) const;
+
+        resource_owner* members;
+        std::size_t size;
+    };
+
+    resource_owner* owners() const;
+
+    /**
+     * @brief Points to the first of the resource owners
+     */
+    strong_lifetime_link members;
+    std::size_t count = 0;
+};
+
+#include "extendable_group_impl.h"
+
+#endif // _EXTENDABLE_GROUP_
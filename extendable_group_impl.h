@@ -0,0 +1,150 @@
+#ifndef _EXTENDABLE_GROUP_IMPL_
+#define _EXTENDABLE_GROUP_IMPL_
+
+#include <new>
+
+template <typename T>
+void extendable_group<T>::release_members::operator()(resource_owner* members) const {
+    extendable_instrumentation<T>::on_control_block_released();
+    for (std::size_t i = 0; i < size; ++i) {
+        members[i].release();
+    }
+}
+
+
+template <typename T>
+template <typename U>
+extendable_group<T>::members_allocator<U>::members_allocator(
+    resource_owner* members, std::size_t size)
+    : members(members)
+    , size(size) {}
+
+template <typename T>
+template <typename U>
+template <typename V>
+extendable_group<T>::members_allocator<U>::members_allocator(
+    const members_allocator<V>& other)
+    : members(other.members)
+    , size(other.size) {}
+
+template <typename T>
+template <typename U>
+U* extendable_group<T>::members_allocator<U>::allocate(std::size_t count) {
+    return control_block_allocator<U>().allocate(count);
+}
+
+template <typename T>
+template <typename U>
+void extendable_group<T>::members_allocator<U>::deallocate(U* memory, std::size_t count) {
+    // the allocator lives in the memory that is being freed
+    auto* owners = members;
+    const auto owner_count = size;
+    control_block_allocator<U>().deallocate(memory, count);
+    control_block_allocator<resource_owner>().deallocate(owners, owner_count);
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+bool extendable_group<T>::members_allocator<U>::operator==(
+    const members_allocator<V>& other) const {
+    return members == other.members;
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+bool extendable_group<T>::members_allocator<U>::operator!=(
+    const members_allocator<V>& other) const {
+    return !(*this == other);
+}
+
+
+template <typename T>
+extendable_group<T>::extendable_group(std::vector<std::unique_ptr<T>> resources)
+    : count(resources.size()) {
+    if (count == 0) {
+        return;
+    }
+    auto* owners = control_block_allocator<resource_owner>().allocate(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        new (&owners[i]) resource_owner(std::move(resources[i]));
+    }
+    try {
+        members = strong_lifetime_link(
+            owners, release_members{count}, members_allocator<resource_owner>(owners, count));
+    } catch (...) {
+        // the deleter has released the members, but the array is not owned by a control block yet
+        extendable_instrumentation<T>::on_control_block_allocated(1, 0);
+        extendable_instrumentation<T>::on_control_block_deallocated(1, 0);
+        control_block_allocator<resource_owner>().deallocate(owners, count);
+        throw;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        extendable_instrumentation<T>::on_create(owners[i]);
+    }
+}
+
+template <typename T>
+extendable_group<T>::~extendable_group() {
+    reset();
+}
+
+template <typename T>
+extendable_group<T>::extendable_group(extendable_group&& other)
+    : members(std::move(other.members))
+    , count(other.count) {
+    other.count = 0;
+}
+
+template <typename T>
+extendable_group<T>& extendable_group<T>::operator=(extendable_group&& other) {
+    if (this != &other) {
+        reset();
+        members = std::move(other.members);
+        count = other.count;
+        other.count = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+std::size_t extendable_group<T>::size() const {
+    return count;
+}
+
+template <typename T>
+T* extendable_group<T>::get(std::size_t index) const {
+    return static_cast<T*>(owners()[index].get());
+}
+
+template <typename T>
+weak_extender<T> extendable_group<T>::extender(std::size_t index) const {
+    return weak_extender<T>(strong_lifetime_link(members, owners() + index));
+}
+
+template <typename T>
+typename extendable_group<T>::resource_owner* extendable_group<T>::owners() const {
+    return static_cast<resource_owner*>(members.get());
+}
+
+template <typename T>
+void extendable_group<T>::reset() {
+    if (members == nullptr) {
+        return;
+    }
+    auto* first = owners();
+    for (std::size_t i = 0; i < count; ++i) {
+        first[i].marked_for_destruction.store(true, std::memory_order_relaxed);
+        extendable_instrumentation<T>::on_reset(first[i]);
+    }
+    // publishes all the marks before the group is released
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (std::size_t i = 0; i < count; ++i) {
+        first[i].notify_reset();
+    }
+    members.reset();
+    count = 0;
+}
+
+#endif // _EXTENDABLE_GROUP_IMPL_
@@ -0,0 +1,73 @@
+#ifndef _EXTENDABLE_HISTOGRAM_
+#define _EXTENDABLE_HISTOGRAM_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A point-in-time copy of a @see latency_histogram which can be merged
+ * with other snapshots and queried for percentiles
+ */
+struct histogram_snapshot {
+    /**
+     * @brief Every power of two is split into 2^sub_bucket_bits linear
+     * sub-buckets, which bounds the relative error of a reported value by 25%
+     */
+    static constexpr std::size_t sub_bucket_bits = 2;
+    static constexpr std::size_t sub_bucket_count = std::size_t(1) << sub_bucket_bits;
+    static constexpr std::size_t bucket_count = 64 * sub_bucket_count;
+
+    static std::size_t bucket_index(std::uint64_t value);
+    /**
+     * @brief The largest value that falls into a bucket
+     */
+    static std::uint64_t bucket_upper_bound(std::size_t index);
+
+    void merge(const histogram_snapshot&);
+
+    /**
+     * @brief Returns the upper bound of the bucket the requested percentile
+     * falls into, or 0 if nothing was recorded
+     * @param percentile A value in [0, 100]
+     */
+    std::uint64_t percentile(double percentile) const;
+    double mean() const;
+
+    std::array<std::uint64_t, bucket_count> counts{};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+};
+
+/**
+ * @brief HDR-style histogram with logarithmic buckets which can be recorded
+ * into from any thread without locks
+ * @details Recording is a handful of relaxed atomic operations. Reading is
+ * done by taking a @see histogram_snapshot, which may be slightly inconsistent
+ * with respect to values that are being recorded concurrently.
+ */
+class latency_histogram {
+public:
+    latency_histogram() = default;
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    void record(std::uint64_t value);
+    /**
+     * @brief Adds the current content of the histogram to the snapshot
+     */
+    void merge_into(histogram_snapshot&) const;
+    histogram_snapshot snapshot() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, histogram_snapshot::bucket_count> counts{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+};
+
+#include "extendable_histogram_impl.h"
+
+#endif // _EXTENDABLE_HISTOGRAM_
@@ -0,0 +1,84 @@
+#ifndef _EXTENDABLE_HISTOGRAM_IMPL_
+#define _EXTENDABLE_HISTOGRAM_IMPL_
+
+#include <algorithm>
+#include <cmath>
+
+inline /*static*/ std::size_t histogram_snapshot::bucket_index(std::uint64_t value) {
+    if (value < sub_bucket_count) {
+        return static_cast<std::size_t>(value);
+    }
+    std::size_t exponent = 0;
+    for (auto rest = value; rest >>= 1;) {
+        ++exponent;
+    }
+    const auto sub_bucket = (value >> (exponent - sub_bucket_bits)) & (sub_bucket_count - 1);
+    return (exponent - sub_bucket_bits + 1) * sub_bucket_count + static_cast<std::size_t>(sub_bucket);
+}
+
+inline /*static*/ std::uint64_t histogram_snapshot::bucket_upper_bound(std::size_t index) {
+    if (index < sub_bucket_count) {
+        return index;
+    }
+    const auto exponent = index / sub_bucket_count + sub_bucket_bits - 1;
+    const auto sub_bucket = index % sub_bucket_count;
+    const auto width = std::uint64_t(1) << (exponent - sub_bucket_bits);
+    return ((sub_bucket_count + sub_bucket) << (exponent - sub_bucket_bits)) + (width - 1);
+}
+
+inline void histogram_snapshot::merge(const histogram_snapshot& other) {
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+inline std::uint64_t histogram_snapshot::percentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(i), max);
+        }
+    }
+    return max;
+}
+
+inline double histogram_snapshot::mean() const {
+    return count != 0 ? static_cast<double>(sum) / count : 0.0;
+}
+
+
+inline void latency_histogram::record(std::uint64_t value) {
+    counts[histogram_snapshot::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto current_max = max.load(std::memory_order_relaxed);
+    while (value > current_max
+           && !max.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {}
+}
+
+inline void latency_histogram::merge_into(histogram_snapshot& snapshot) const {
+    for (std::size_t i = 0; i < histogram_snapshot::bucket_count; ++i) {
+        const auto bucket = counts[i].load(std::memory_order_relaxed);
+        snapshot.counts[i] += bucket;
+        snapshot.count += bucket;
+    }
+    snapshot.sum += sum.load(std::memory_order_relaxed);
+    snapshot.max = std::max(snapshot.max, max.load(std::memory_order_relaxed));
+}
+
+inline histogram_snapshot latency_histogram::snapshot() const {
+    histogram_snapshot result;
+    merge_into(result);
+    return result;
+}
+
+#endif // _EXTENDABLE_HISTOGRAM_IMPL_
@@ -0,0 +1,141 @@
+#ifndef _EXTENDABLE_INDEX_
+#define _EXTENDABLE_INDEX_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Maps names or IDs to @see weak_extender-s, lookups never lock and
+ * never return a resource that was reset
+ * @details An open-addressing table with linear probing. A lookup compares
+ * the stored hashes and enters only the slot whose hash matches, by counting
+ * itself as its reader, to compare the key and copy the extender. Inserts and
+ * erases are serialized by a mutex that lookups never wait for.
+ *
+ * Every entry subscribes to the reset of its resource (@see
+ * reset_subscriptions), so resetting the unique_extendable_ptr, the group or
+ * the range passed to reset_all() drops the entry. The reset then briefly
+ * takes the mutex of the index. A lookup that races with the reset checks
+ * whether the resource was marked for destruction and finds nothing.
+ *
+ * The number of slots is fixed at construction, an insert fails once no slot
+ * is free. Probing stays short while at most about a half of them is used.
+ * Erased slots are reused by the following inserts, and a run of them that
+ * ends at an empty slot becomes empty again right away, so lookups that miss
+ * do not walk over the erased entries of an index that keeps being filled
+ * and emptied.
+ *
+ * @tparam Key Name or ID, hashed by std::hash<Key>
+ * @tparam T Type of the resources
+ */
+template <typename Key, typename T>
+class extendable_index {
+public:
+    /**
+     * @param slot_count Rounded up to a power of two
+     */
+    explicit extendable_index(std::size_t slot_count);
+    /**
+     * @brief Drops the reset subscriptions of the remaining entries
+     */
+    ~extendable_index();
+
+    extendable_index(const extendable_index&) = delete;
+    extendable_index& operator=(const extendable_index&) = delete;
+
+    /**
+     * @return false if the key already maps to an accessible resource, the
+     * resource is not accessible or no slot is free
+     */
+    bool insert(const Key&, const weak_extender<T>&);
+    /**
+     * @return false if the key is not in the index
+     */
+    bool erase(const Key&);
+    /**
+     * @brief Returns the extender the key maps to, an empty one if the key is
+     * not in the index or its resource was marked for destruction
+     */
+    weak_extender<T> find(const Key&) const;
+
+    /**
+     * @brief Number of the entries
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @brief Kind of a slot in the low bits of its state, the rest counts the
+     * lookups that compare its key
+     */
+    enum : std::uint32_t {
+        empty = 0,
+        busy = 1,
+        full = 2,
+        erased = 3,
+        kind_mask = 3,
+        reader = 4
+    };
+
+    struct slot {
+        std::atomic<std::size_t> hash{0};
+        std::atomic<std::uint32_t> state{empty};
+        /**
+         * @brief Written only while the slot is busy
+         */
+        Key key{};
+        weak_extender<T> extender;
+    };
+
+    /**
+     * @brief Outlives the index while a reset callback uses it
+     */
+    struct table {
+        explicit table(std::size_t slot_count);
+
+        slot& first_slot(std::size_t hash) const;
+        slot& next_slot(const slot&) const;
+        slot& previous_slot(const slot&) const;
+        /**
+         * @brief Erases the entry, waits for the lookups that compare its key
+         * if asked to, requires the writers mutex
+         * @return false if the slot is still read and was not waited for
+         */
+        bool remove(slot&, bool wait);
+        /**
+         * @brief Empties the erased slots that end at an empty slot, going
+         * back from the given one, requires the writers mutex
+         * @details Lookups stop at the empty slot anyway, so none can tell
+         * the difference, not even a concurrent one.
+         */
+        void reclaim(slot&);
+        /**
+         * @brief Erases the entry if its resource is no longer accessible and
+         * no lookup reads it, requires the writers mutex
+         */
+        bool try_prune(slot&);
+        /**
+         * @brief Subscribed to the reset of every resource
+         */
+        static void on_reset(const std::weak_ptr<table>&, slot&, const void* owner);
+
+        std::size_t mask;
+        std::unique_ptr<slot[]> slots;
+        std::atomic<std::size_t> count{0};
+        std::mutex writers;
+    };
+
+    static bool accessible(const weak_extender<T>&);
+
+    std::shared_ptr<table> entries;
+};
+
+#include "extendable_index_impl.h"
+
+#endif // _EXTENDABLE_INDEX_
@@ -0,0 +1,227 @@
+#ifndef _EXTENDABLE_INDEX_IMPL_
+#define _EXTENDABLE_INDEX_IMPL_
+
+#include <thread>
+#include <utility>
+
+template <typename Key, typename T>
+extendable_index<Key, T>::extendable_index(std::size_t slot_count)
+    : entries(std::make_shared<table>(slot_count)) {}
+
+template <typename Key, typename T>
+extendable_index<Key, T>::~extendable_index() {
+    std::lock_guard<std::mutex> lock(entries->writers);
+    for (std::size_t index = 0; index <= entries->mask; ++index) {
+        auto& entry = entries->slots[index];
+        if ((entry.state.load(std::memory_order_relaxed) & kind_mask) == full) {
+            reset_subscriptions::remove(entry.extender.target, &entry);
+        }
+    }
+}
+
+template <typename Key, typename T>
+bool extendable_index<Key, T>::insert(const Key& key, const weak_extender<T>& extender) {
+    if (!accessible(extender)) {
+        return false;
+    }
+    const auto hash = std::hash<Key>()(key);
+    auto& map = *entries;
+    std::lock_guard<std::mutex> lock(map.writers);
+    slot* reusable = nullptr;
+    auto* probed = &map.first_slot(hash);
+    // the whole chain up to an empty slot is checked for the key, only then
+    // an erased slot in it may be reused
+    for (std::size_t step = 0; step <= map.mask; ++step, probed = &map.next_slot(*probed)) {
+        const auto kind = probed->state.load(std::memory_order_acquire) & kind_mask;
+        if (kind == empty) {
+            if (reusable == nullptr) {
+                reusable = probed;
+            }
+            break;
+        }
+        if (kind == full) {
+            const bool same_key =
+                probed->hash.load(std::memory_order_relaxed) == hash && probed->key == key;
+            if (!map.try_prune(*probed)) {
+                if (same_key) {
+                    return false;
+                }
+                continue;
+            }
+        }
+        if (reusable == nullptr) {
+            reusable = probed;
+        }
+    }
+    if (reusable == nullptr) {
+        return false;
+    }
+
+    const auto* owner = extender.target;
+    std::weak_ptr<table> weak_map = entries;
+    if (!reset_subscriptions::add(*owner, reusable, [weak_map, reusable, owner] {
+            table::on_reset(weak_map, *reusable, owner);
+        })) {
+        return false;
+    }
+    reusable->state.store(busy, std::memory_order_relaxed);
+    reusable->key = key;
+    reusable->extender = extender;
+    reusable->hash.store(hash, std::memory_order_relaxed);
+    reusable->state.store(full, std::memory_order_release);
+    map.count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename Key, typename T>
+bool extendable_index<Key, T>::erase(const Key& key) {
+    const auto hash = std::hash<Key>()(key);
+    auto& map = *entries;
+    std::lock_guard<std::mutex> lock(map.writers);
+    auto* probed = &map.first_slot(hash);
+    for (std::size_t step = 0; step <= map.mask; ++step, probed = &map.next_slot(*probed)) {
+        const auto kind = probed->state.load(std::memory_order_acquire) & kind_mask;
+        if (kind == empty) {
+            return false;
+        }
+        if (kind != full) {
+            continue;
+        }
+        if (probed->hash.load(std::memory_order_relaxed) == hash && probed->key == key) {
+            return map.remove(*probed, true);
+        }
+        map.try_prune(*probed);
+    }
+    return false;
+}
+
+template <typename Key, typename T>
+weak_extender<T> extendable_index<Key, T>::find(const Key& key) const {
+    struct reading {
+        ~reading() {
+            read.state.fetch_sub(reader, std::memory_order_release);
+        }
+        slot& read;
+    };
+
+    const auto hash = std::hash<Key>()(key);
+    const auto& map = *entries;
+    auto* probed = &map.first_slot(hash);
+    for (std::size_t step = 0; step <= map.mask; ++step, probed = &map.next_slot(*probed)) {
+        auto state = probed->state.load(std::memory_order_acquire);
+        if ((state & kind_mask) == empty) {
+            break;
+        }
+        if (probed->hash.load(std::memory_order_relaxed) != hash) {
+            continue;
+        }
+        bool entered = false;
+        while ((state & kind_mask) == full && !entered) {
+            entered = probed->state.compare_exchange_weak(
+                state, state + reader, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+        if (!entered) {
+            continue;
+        }
+        const reading guard{*probed};
+        if (probed->key == key) {
+            return accessible(probed->extender) ? probed->extender : weak_extender<T>();
+        }
+    }
+    return weak_extender<T>();
+}
+
+template <typename Key, typename T>
+std::size_t extendable_index<Key, T>::size() const {
+    return entries->count.load(std::memory_order_relaxed);
+}
+
+template <typename Key, typename T>
+/*static*/ bool extendable_index<Key, T>::accessible(const weak_extender<T>& extender) {
+    return extender.accessible_in_scope();
+}
+
+
+template <typename Key, typename T>
+extendable_index<Key, T>::table::table(std::size_t slot_count)
+    : mask(1) {
+    while (mask < slot_count) {
+        mask <<= 1;
+    }
+    slots.reset(new slot[mask]);
+    --mask;
+}
+
+template <typename Key, typename T>
+typename extendable_index<Key, T>::slot& extendable_index<Key, T>::table::first_slot(std::size_t hash) const {
+    return slots[hash & mask];
+}
+
+template <typename Key, typename T>
+typename extendable_index<Key, T>::slot& extendable_index<Key, T>::table::next_slot(const slot& current) const {
+    return slots[(&current - slots.get() + 1) & mask];
+}
+
+template <typename Key, typename T>
+typename extendable_index<Key, T>::slot& extendable_index<Key, T>::table::previous_slot(const slot& current) const {
+    return slots[(&current - slots.get() - 1) & mask];
+}
+
+template <typename Key, typename T>
+bool extendable_index<Key, T>::table::remove(slot& removed, bool wait) {
+    auto expected = std::uint32_t(full);
+    while (!removed.state.compare_exchange_strong(expected, busy, std::memory_order_acquire)) {
+        if (!wait) {
+            return false;
+        }
+        expected = full;
+        std::this_thread::yield();
+    }
+    const void* owner = removed.extender.target;
+    removed.extender.reset();
+    removed.key = Key();
+    removed.hash.store(0, std::memory_order_relaxed);
+    removed.state.store(erased, std::memory_order_release);
+    count.fetch_sub(1, std::memory_order_relaxed);
+    reclaim(removed);
+    // a no-op when called from the reset itself
+    reset_subscriptions::remove(owner, &removed);
+    return true;
+}
+
+template <typename Key, typename T>
+void extendable_index<Key, T>::table::reclaim(slot& last) {
+    // every run of erased slots ends at a full one otherwise, once the index
+    // is empty no slot is full and either none is empty or none is erased
+    if ((next_slot(last).state.load(std::memory_order_relaxed) & kind_mask) != empty
+        && count.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    auto* reclaimed = &last;
+    for (std::size_t step = 0; step <= mask; ++step, reclaimed = &previous_slot(*reclaimed)) {
+        if ((reclaimed->state.load(std::memory_order_relaxed) & kind_mask) != erased) {
+            return;
+        }
+        reclaimed->state.store(empty, std::memory_order_release);
+    }
+}
+
+template <typename Key, typename T>
+bool extendable_index<Key, T>::table::try_prune(slot& pruned) {
+    return !accessible(pruned.extender) && remove(pruned, false);
+}
+
+template <typename Key, typename T>
+/*static*/ void extendable_index<Key, T>::table::on_reset(
+    const std::weak_ptr<table>& weak_map, slot& entry, const void* owner) {
+    const auto map = weak_map.lock();
+    if (map == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(map->writers);
+    if ((entry.state.load(std::memory_order_relaxed) & kind_mask) == full && entry.extender.target == owner) {
+        map->remove(entry, true);
+    }
+}
+
+#endif // _EXTENDABLE_INDEX_IMPL_
@@ -0,0 +1,216 @@
+#ifndef _EXTENDABLE_INSTRUMENTATION_
+#define _EXTENDABLE_INSTRUMENTATION_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Opt-in instrumentation of resource lifetimes. Every kind of instrumentation
+ * is enabled by defining the corresponding macro before including
+ * extendable_unique_ownership.h (or project-wide), and compiles to nothing
+ * otherwise:
+ *
+ * EXTENDABLE_ENABLE_HISTOGRAMS - @see extendable_histograms
+ * EXTENDABLE_ENABLE_LONG_HOLD_DETECTION - @see long_hold_detector
+ * EXTENDABLE_ENABLE_TRACING - @see extendable_tracer
+ * EXTENDABLE_ENABLE_STATS - @see extendable_stats
+ * EXTENDABLE_ENABLE_ACCOUNTING - @see extendable_accounting
+ * EXTENDABLE_ENABLE_DESTRUCTION_BLAME - @see destruction_blame
+ */
+
+#if defined(EXTENDABLE_ENABLE_LONG_HOLD_DETECTION) || defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+#define EXTENDABLE_CAPTURE_CALL_SITES
+#endif
+
+#if defined(EXTENDABLE_ENABLE_HISTOGRAMS) || defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+#define EXTENDABLE_TIMESTAMP_RESETS
+#endif
+
+#if defined(EXTENDABLE_ENABLE_HISTOGRAMS) || defined(EXTENDABLE_ENABLE_TRACING)
+#define EXTENDABLE_TIMESTAMP_LOCKS
+#endif
+
+#if defined(EXTENDABLE_CAPTURE_CALL_SITES)
+#include <source_location>
+#endif
+
+/**
+ * @brief Monotonic clock used by the instrumentation, in nanoseconds
+ */
+std::int64_t instrumentation_clock_ns();
+
+#if defined(EXTENDABLE_ENABLE_HISTOGRAMS)
+#include "extendable_lifetime_histograms.h"
+#endif
+#if defined(EXTENDABLE_ENABLE_LONG_HOLD_DETECTION)
+#include "extendable_long_hold_detector.h"
+#endif
+#if defined(EXTENDABLE_ENABLE_TRACING)
+#include "extendable_tracer.h"
+#endif
+#if defined(EXTENDABLE_ENABLE_STATS)
+#include "extendable_stats.h"
+#endif
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+#include "extendable_accounting.h"
+#endif
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+#include "extendable_destruction_blame.h"
+#endif
+
+#if defined(EXTENDABLE_CAPTURE_CALL_SITES)
+/**
+ * @brief Call site of weak_extender::lock(), captured only when some of the
+ * enabled instrumentation needs it
+ */
+using extendable_call_site = std::source_location;
+#else
+struct extendable_call_site {
+    static constexpr extendable_call_site current() { return {}; }
+};
+#endif
+
+/**
+ * @brief Per-resource data of the enabled instrumentation
+ * @details Is a base of @see extendable_core, so it takes no
+ * space when no instrumentation is enabled
+ */
+struct resource_instrumentation {
+#if defined(EXTENDABLE_TIMESTAMP_RESETS)
+    /**
+     * @brief Time of unique_extendable_ptr::reset(), 0 if it did not happen yet
+     */
+    std::atomic<std::int64_t> reset_time_ns{0};
+#endif
+};
+
+/**
+ * @brief Per-extender data of the enabled instrumentation
+ * @details Is a base of @see scoped_extender, so it takes no space when no
+ * instrumentation is enabled
+ */
+struct extender_instrumentation {
+#if defined(EXTENDABLE_TIMESTAMP_LOCKS)
+    std::int64_t lock_time_ns = 0;
+#endif
+#if defined(EXTENDABLE_ENABLE_LONG_HOLD_DETECTION)
+    /**
+     * @brief Table of the thread that has locked, the extender may be
+     * released on another one
+     */
+    std::shared_ptr<long_hold_detector::thread_table> hold_table;
+    int hold_slot = long_hold_detector::untracked;
+#endif
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    extendable_call_site call_site;
+#endif
+};
+
+/**
+ * @brief Data of the enabled instrumentation about the release of a
+ * scoped_extender, kept with its reference when the reference is dropped
+ * later than the release: parked for the other extenders of the resource in
+ * the same thread, or queued to the thread that has registered the extender
+ * @details Is a base of the kept references, so it takes no space when no
+ * instrumentation needs it
+ */
+struct deferred_release_instrumentation {
+    /**
+     * @brief Captures the release that is in progress in the calling thread
+     */
+    static deferred_release_instrumentation capture();
+
+    /**
+     * @brief Makes a captured release the one in progress in the calling
+     * thread for its lifetime
+     */
+    class resumed {
+    public:
+        explicit resumed(const deferred_release_instrumentation&);
+        ~resumed();
+
+        resumed(const resumed&) = delete;
+        resumed& operator=(const resumed&) = delete;
+
+    private:
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+        const extendable_call_site* interrupted;
+#endif
+    };
+
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    extendable_call_site call_site;
+    bool captured = false;
+#endif
+};
+
+/**
+ * @brief Lifetime events reported by the smart pointers to the enabled
+ * instrumentation. Every function is empty when no instrumentation is enabled.
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+struct extendable_instrumentation {
+    /**
+     * @brief A resource was taken over by a unique_extendable_ptr
+     */
+    static void on_create(const resource_instrumentation&);
+    /**
+     * @brief weak_extender::lock() has successfully produced a scoped_extender
+     */
+    static void on_lock(
+        extender_instrumentation&, const resource_instrumentation&, const extendable_call_site&);
+    /**
+     * @brief weak_extender::lock() has produced a scoped_extender that borrows
+     * the reference of an enclosing scoped_extender or of an extension_scope,
+     * its release is not reported
+     */
+    static void on_lock_borrowed();
+    /**
+     * @brief weak_extender::lock() has produced an empty scoped_extender
+     * @param resource nullptr if the resource was already destroyed
+     * @param marked_for_destruction Whether the resource was still alive but
+     * already reset by its unique_extendable_ptr
+     */
+    static void on_lock_failed(const resource_instrumentation* resource, bool marked_for_destruction);
+    /**
+     * @brief A non-empty scoped_extender has stopped extending the resource
+     * @param marked_for_destruction Flag of the resource, read only by the
+     * instrumentation that needs it
+     */
+    static void on_release(
+        const extender_instrumentation&,
+        const resource_instrumentation&,
+        const std::atomic_bool& marked_for_destruction);
+    /**
+     * @brief The scoped_extender has dropped its reference, which may have
+     * destroyed the resource in the calling thread
+     */
+    static void after_release(const extender_instrumentation&);
+    /**
+     * @brief The resource was marked for destruction by its unique_extendable_ptr
+     */
+    static void on_reset(resource_instrumentation&);
+    /**
+     * @brief The resource is about to be handed to the destruction policy
+     */
+    static void on_destroy(const resource_instrumentation&);
+    /**
+     * @brief Memory for a control block (shared by the reference counts and
+     * the resource_owner) was allocated
+     * @param blocks 0 for memory that belongs to a control block counted
+     * elsewhere, e.g. the resource owners of an extendable_group
+     */
+    static void on_control_block_allocated(std::size_t blocks, std::size_t bytes);
+    /**
+     * @brief The last strong reference to a control block is gone, it stays
+     * allocated as long as any weak_extender refers to it
+     */
+    static void on_control_block_released();
+    static void on_control_block_deallocated(std::size_t blocks, std::size_t bytes);
+};
+
+#include "extendable_instrumentation_impl.h"
+
+#endif // _EXTENDABLE_INSTRUMENTATION_
@@ -0,0 +1,211 @@
+#ifndef _EXTENDABLE_INSTRUMENTATION_IMPL_
+#define _EXTENDABLE_INSTRUMENTATION_IMPL_
+
+#include <chrono>
+#include <typeinfo>
+
+inline std::int64_t instrumentation_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+inline /*static*/ deferred_release_instrumentation deferred_release_instrumentation::capture() {
+    deferred_release_instrumentation release;
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    if (const auto* call_site = destruction_blame::releasing_call_site()) {
+        release.call_site = *call_site;
+        release.captured = true;
+    }
+#endif
+    return release;
+}
+
+inline deferred_release_instrumentation::resumed::resumed(const deferred_release_instrumentation& release) {
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    interrupted = destruction_blame::releasing_call_site();
+    if (release.captured) {
+        destruction_blame::set_releasing_call_site(&release.call_site);
+    }
+#endif
+    (void)release;
+}
+
+inline deferred_release_instrumentation::resumed::~resumed() {
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    destruction_blame::set_releasing_call_site(interrupted);
+#endif
+}
+
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_create(const resource_instrumentation& resource) {
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(&resource)) {
+        extendable_tracer::record(trace_event_kind::create, &resource, typeid(T).name());
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    extendable_accounting<T>::add_owners(1);
+    extendable_accounting<T>::add_resources(1);
+#endif
+    (void)resource;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_lock(
+    extender_instrumentation& extender,
+    const resource_instrumentation& resource,
+    const extendable_call_site& call_site) {
+#if defined(EXTENDABLE_TIMESTAMP_LOCKS)
+    extender.lock_time_ns = instrumentation_clock_ns();
+#endif
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(&resource)) {
+        extendable_tracer::record(trace_event_kind::lock, &resource, typeid(T).name());
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_LONG_HOLD_DETECTION)
+    extender.hold_slot = long_hold_detector::begin_hold(extender.hold_table, call_site, typeid(T).name());
+#endif
+#if defined(EXTENDABLE_ENABLE_STATS)
+    extendable_stats<T>::count_lock_hit();
+#endif
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    extender.call_site = call_site;
+#endif
+    (void)extender;
+    (void)resource;
+    (void)call_site;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_lock_borrowed() {
+#if defined(EXTENDABLE_ENABLE_STATS)
+    extendable_stats<T>::count_lock_hit();
+#endif
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_lock_failed(
+    const resource_instrumentation* resource, bool marked_for_destruction) {
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(resource)) {
+        extendable_tracer::record(trace_event_kind::lock_failed, resource, typeid(T).name());
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_STATS)
+    extendable_stats<T>::count_lock_miss(marked_for_destruction);
+#endif
+    (void)resource;
+    (void)marked_for_destruction;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_release(
+    const extender_instrumentation& extender,
+    const resource_instrumentation& resource,
+    const std::atomic_bool& marked_for_destruction) {
+#if defined(EXTENDABLE_ENABLE_HISTOGRAMS)
+    extendable_histograms<T>::record_hold(instrumentation_clock_ns() - extender.lock_time_ns);
+#endif
+#if defined(EXTENDABLE_ENABLE_LONG_HOLD_DETECTION)
+    long_hold_detector::end_hold(extender.hold_table, extender.hold_slot);
+#endif
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(&resource)) {
+        extendable_tracer::record(
+            trace_event_kind::release, &resource, typeid(T).name(), extender.lock_time_ns);
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_STATS)
+    if (marked_for_destruction.load(std::memory_order_relaxed)) {
+        extendable_stats<T>::count_outlived_owner();
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    destruction_blame::set_releasing_call_site(&extender.call_site);
+#endif
+    (void)extender;
+    (void)resource;
+    (void)marked_for_destruction;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::after_release(const extender_instrumentation& extender) {
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    destruction_blame::set_releasing_call_site(nullptr);
+#endif
+    (void)extender;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_reset(resource_instrumentation& resource) {
+#if defined(EXTENDABLE_TIMESTAMP_RESETS)
+    resource.reset_time_ns.store(instrumentation_clock_ns(), std::memory_order_relaxed);
+#endif
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(&resource)) {
+        extendable_tracer::record(trace_event_kind::reset, &resource, typeid(T).name());
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    extendable_accounting<T>::add_owners(-1);
+#endif
+    (void)resource;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_destroy(const resource_instrumentation& resource) {
+#if defined(EXTENDABLE_ENABLE_HISTOGRAMS)
+    const auto reset_time = resource.reset_time_ns.load(std::memory_order_relaxed);
+    if (reset_time != 0) {
+        extendable_histograms<T>::record_destruction_delay(instrumentation_clock_ns() - reset_time);
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_TRACING)
+    if (extendable_tracer::sampled(&resource)) {
+        extendable_tracer::record(trace_event_kind::destroy, &resource, typeid(T).name());
+    }
+#endif
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    extendable_accounting<T>::add_resources(-1);
+#endif
+#if defined(EXTENDABLE_ENABLE_DESTRUCTION_BLAME)
+    destruction_blame::on_destroy(typeid(T).name(), resource.reset_time_ns.load(std::memory_order_relaxed));
+#endif
+    (void)resource;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_control_block_allocated(
+    std::size_t blocks, std::size_t bytes) {
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    extendable_accounting<T>::add_control_blocks(
+        static_cast<std::int64_t>(blocks), static_cast<std::int64_t>(bytes));
+#endif
+    (void)blocks;
+    (void)bytes;
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_control_block_released() {
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    extendable_accounting<T>::add_dead_control_blocks(1);
+#endif
+}
+
+template <typename T>
+/*static*/ void extendable_instrumentation<T>::on_control_block_deallocated(
+    std::size_t blocks, std::size_t bytes) {
+#if defined(EXTENDABLE_ENABLE_ACCOUNTING)
+    // every control block is released before it is deallocated
+    extendable_accounting<T>::add_control_blocks(
+        -static_cast<std::int64_t>(blocks), -static_cast<std::int64_t>(bytes));
+    extendable_accounting<T>::add_dead_control_blocks(-static_cast<std::int64_t>(blocks));
+#endif
+    (void)blocks;
+    (void)bytes;
+}
+
+#endif // _EXTENDABLE_INSTRUMENTATION_IMPL_
@@ -0,0 +1,154 @@
+#ifndef _EXTENDABLE_LEASE_
+#define _EXTENDABLE_LEASE_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Forcibly expires the @see lease-s whose deadline has passed
+ * @details Leases bounded by time are expired by reap(), which is called
+ * periodically by the reaper thread started with start() and may be called
+ * directly as well, e.g. once per frame. Leases bounded by a number of frames
+ * are expired by advance_frame(), which should be called once per frame.
+ * Without either of them the leases are released only by their holders.
+ */
+class lease_reaper {
+public:
+    /**
+     * @brief Starts the reaper thread. Does nothing if it is already running.
+     */
+    static void start(std::chrono::nanoseconds period = std::chrono::milliseconds(1));
+    static void stop();
+
+    /**
+     * @brief Expires the leases whose time is up
+     * @return Number of the leases expired by this call
+     */
+    static std::size_t reap();
+    /**
+     * @brief Moves on to the next frame and expires the leases whose frames
+     * are over
+     * @return Number of the leases expired by this call
+     */
+    static std::size_t advance_frame();
+    static std::uint64_t frame();
+
+private:
+    template <typename T> friend class lease;
+    template <typename T> friend class weak_extender;
+
+    using clock = std::chrono::steady_clock;
+
+    struct record {
+        /**
+         * @brief Releases the reference unless somebody already did it
+         */
+        bool try_expire();
+
+        std::atomic<bool> expired{false};
+        clock::time_point deadline = clock::time_point::max();
+        std::uint64_t deadline_frame = UINT64_MAX;
+        /**
+         * @brief Accessed only by the one that expires the record
+         */
+        std::shared_ptr<void> reference;
+        std::atomic<std::uint32_t>* leases = nullptr;
+    };
+
+    struct state {
+        /**
+         * @brief Stops the reaper thread if it is still running, so that
+         * exiting without stop() does not terminate the process
+         */
+        ~state();
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<record>> records;
+        std::atomic<std::uint64_t> frame{0};
+
+        std::mutex reaper_mutex;
+        std::condition_variable reaper_wake;
+        std::thread reaper;
+        bool stopping = false;
+    };
+
+    static state& global();
+    static void add(const std::shared_ptr<record>&);
+    /**
+     * @brief The part of weak_extender::lease_until() that does not depend
+     * on the type of the resource
+     * @return Empty if the resource is not accessible
+     */
+    static std::shared_ptr<record> make_record(
+        const extendable_core::weak_lifetime_link&, clock::time_point deadline, std::uint64_t deadline_frame);
+    static std::size_t expire_due(clock::time_point now, std::uint64_t frame);
+};
+
+/**
+ * @brief Storable handle that extends the lifetime of a resource until
+ * a deadline, obtained from weak_extender::lease_until() or
+ * weak_extender::lease_for_frames()
+ * @details Meant for consumers that need a resource for a few frames (e.g.
+ * a render snapshot) without locking it every frame. Unlike
+ * @see scoped_extender a lease may be stored, and the resource stays
+ * accessible through it after the owner is reset, but only until the
+ * deadline: then the @see lease_reaper releases it whether the holder is done
+ * or not, so the delay a lease adds to the destruction is bounded.
+ *
+ * Since the reference may be released at any moment, the resource is accessed
+ * only inside an @see extension_scope, which keeps it alive until the scope
+ * closes. Leases are counted in the control block separately from the
+ * scoped_extender-s, see unique_extendable_ptr::leases().
+ *
+ * @tparam T Type of the leased resource
+ */
+template <typename T>
+class lease {
+public:
+    lease() = default;
+    /**
+     * @brief @see reset()
+     */
+    ~lease();
+
+    lease(const lease&) = delete;
+    lease& operator=(const lease&) = delete;
+    lease(lease&&) = default;
+    /**
+     * @brief Releases the current lease before taking over the other one
+     */
+    lease& operator=(lease&&);
+
+    /**
+     * @brief Returns the resource, or nullptr if the lease has expired
+     * @details The pointer may be used until the scope is closed
+     */
+    T* get(const extension_scope&) const;
+    bool expired() const;
+
+    /**
+     * @brief Releases the lease before its deadline
+     */
+    void reset();
+
+private:
+    friend class weak_extender<T>;
+
+    lease(std::shared_ptr<lease_reaper::record>, T*);
+
+    std::shared_ptr<lease_reaper::record> record;
+    T* resource = nullptr;
+};
+
+#include "extendable_lease_impl.h"
+
+#endif // _EXTENDABLE_LEASE_
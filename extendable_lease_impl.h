@@ -0,0 +1,194 @@
+#ifndef _EXTENDABLE_LEASE_IMPL_
+#define _EXTENDABLE_LEASE_IMPL_
+
+inline bool lease_reaper::record::try_expire() {
+    if (expired.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    leases->fetch_sub(1, std::memory_order_relaxed);
+    // may destroy the resource, extension_scope defers it if the holder is
+    // still using the resource
+    reference.reset();
+    return true;
+}
+
+inline /*static*/ void lease_reaper::start(std::chrono::nanoseconds period) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.reaper_mutex);
+    if (state.reaper.joinable()) {
+        return;
+    }
+    state.stopping = false;
+    state.reaper = std::thread([period] {
+        auto& state = global();
+        std::unique_lock<std::mutex> lock(state.reaper_mutex);
+        while (!state.reaper_wake.wait_for(lock, period, [&] { return state.stopping; })) {
+            lock.unlock();
+            reap();
+            lock.lock();
+        }
+    });
+}
+
+inline /*static*/ void lease_reaper::stop() {
+    auto& state = global();
+    std::thread reaper;
+    {
+        std::lock_guard<std::mutex> lock(state.reaper_mutex);
+        state.stopping = true;
+        reaper = std::move(state.reaper);
+    }
+    state.reaper_wake.notify_all();
+    if (reaper.joinable()) {
+        reaper.join();
+    }
+}
+
+inline /*static*/ std::size_t lease_reaper::reap() {
+    return expire_due(clock::now(), frame());
+}
+
+inline /*static*/ std::size_t lease_reaper::advance_frame() {
+    const auto next = global().frame.fetch_add(1, std::memory_order_relaxed) + 1;
+    return expire_due(clock::now(), next);
+}
+
+inline /*static*/ std::uint64_t lease_reaper::frame() {
+    return global().frame.load(std::memory_order_relaxed);
+}
+
+inline lease_reaper::state::~state() {
+    {
+        std::lock_guard<std::mutex> lock(reaper_mutex);
+        stopping = true;
+    }
+    reaper_wake.notify_all();
+    if (reaper.joinable()) {
+        reaper.join();
+    }
+}
+
+inline /*static*/ lease_reaper::state& lease_reaper::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ void lease_reaper::add(const std::shared_ptr<record>& added) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.records.push_back(added);
+}
+
+inline /*static*/ std::shared_ptr<lease_reaper::record> lease_reaper::make_record(
+    const extendable_core::weak_lifetime_link& link, clock::time_point deadline, std::uint64_t deadline_frame) {
+    auto strong_link = link.lock();
+    if (!extendable_core::not_marked_for_destruction(strong_link.get()) || strong_link->get() == nullptr) {
+        return nullptr;
+    }
+    strong_link->leases.fetch_add(1, std::memory_order_relaxed);
+
+    auto added = std::make_shared<record>();
+    added->deadline = deadline;
+    added->deadline_frame = deadline_frame;
+    added->leases = &strong_link->leases;
+    added->reference = std::move(strong_link);
+    add(added);
+    return added;
+}
+
+inline /*static*/ std::size_t lease_reaper::expire_due(clock::time_point now, std::uint64_t frame) {
+    auto& state = global();
+    std::vector<std::shared_ptr<record>> due;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto& records = state.records;
+        for (std::size_t i = 0; i < records.size();) {
+            const auto& candidate = *records[i];
+            const bool released = candidate.expired.load(std::memory_order_relaxed);
+            if (released || candidate.deadline <= now || candidate.deadline_frame <= frame) {
+                if (!released) {
+                    due.push_back(std::move(records[i]));
+                }
+                records[i] = std::move(records.back());
+                records.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+    // outside of the lock, since the released resources may be destroyed here
+    std::size_t expired = 0;
+    for (const auto& record : due) {
+        expired += record->try_expire() ? 1 : 0;
+    }
+    return expired;
+}
+
+
+template <typename T>
+lease<T>::lease(std::shared_ptr<lease_reaper::record> record, T* resource)
+    : record(std::move(record))
+    , resource(resource) {}
+
+template <typename T>
+lease<T>::~lease() {
+    reset();
+}
+
+template <typename T>
+lease<T>& lease<T>::operator=(lease&& other) {
+    if (this != &other) {
+        reset();
+        record = std::move(other.record);
+        resource = other.resource;
+        other.resource = nullptr;
+    }
+    return *this;
+}
+
+template <typename T>
+T* lease<T>::get(const extension_scope&) const {
+    return !expired() ? resource : nullptr;
+}
+
+template <typename T>
+bool lease<T>::expired() const {
+    return record == nullptr || record->expired.load();
+}
+
+template <typename T>
+void lease<T>::reset() {
+    if (record != nullptr) {
+        record->try_expire();
+        record.reset();
+    }
+    resource = nullptr;
+}
+
+
+template <typename T>
+lease<T> weak_extender<T>::lease_until(std::chrono::steady_clock::time_point deadline) const {
+    return make_lease(deadline, UINT64_MAX);
+}
+
+template <typename T>
+lease<T> weak_extender<T>::lease_for_frames(std::uint64_t frames) const {
+    return make_lease(std::chrono::steady_clock::time_point::max(), lease_reaper::frame() + frames);
+}
+
+template <typename T>
+lease<T> weak_extender<T>::make_lease(
+    std::chrono::steady_clock::time_point deadline, std::uint64_t deadline_frame) const {
+    auto record = lease_reaper::make_record(link, deadline, deadline_frame);
+    if (record == nullptr) {
+        return lease<T>();
+    }
+    return lease<T>(std::move(record), target_resource());
+}
+
+template <typename T>
+std::size_t unique_extendable_ptr<T>::leases() const {
+    return resource != nullptr ? resource->leases.load(std::memory_order_relaxed) : 0;
+}
+
+#endif // _EXTENDABLE_LEASE_IMPL_
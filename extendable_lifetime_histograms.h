@@ -0,0 +1,61 @@
+#ifndef _EXTENDABLE_LIFETIME_HISTOGRAMS_
+#define _EXTENDABLE_LIFETIME_HISTOGRAMS_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "extendable_histogram.h"
+
+/**
+ * @brief Merged content of @see extendable_histograms for a single type
+ */
+struct lifetime_histograms {
+    /**
+     * @brief Time between weak_extender::lock() and the release of the
+     * produced scoped_extender
+     */
+    histogram_snapshot hold_ns;
+    /**
+     * @brief Time between unique_extendable_ptr::reset() and the actual
+     * destruction of the resource
+     */
+    histogram_snapshot destruction_delay_ns;
+};
+
+/**
+ * @brief Per-type histograms of how long resources are extended, enabled by
+ * EXTENDABLE_ENABLE_HISTOGRAMS
+ * @details Every thread records into its own set of histograms, so recording
+ * involves no contended atomics. The per-thread histograms are merged only
+ * when a snapshot is requested and outlive the threads that recorded them.
+ *
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+class extendable_histograms {
+public:
+    static lifetime_histograms snapshot();
+
+    static void record_hold(std::int64_t nanoseconds);
+    static void record_destruction_delay(std::int64_t nanoseconds);
+
+private:
+    struct thread_histograms {
+        latency_histogram hold_ns;
+        latency_histogram destruction_delay_ns;
+    };
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_histograms>> threads;
+    };
+
+    static registry& all_threads();
+    static thread_histograms& this_thread();
+};
+
+#include "extendable_lifetime_histograms_impl.h"
+
+#endif // _EXTENDABLE_LIFETIME_HISTOGRAMS_
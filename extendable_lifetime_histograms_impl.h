@@ -0,0 +1,48 @@
+#ifndef _EXTENDABLE_LIFETIME_HISTOGRAMS_IMPL_
+#define _EXTENDABLE_LIFETIME_HISTOGRAMS_IMPL_
+
+#include <algorithm>
+
+template <typename T>
+/*static*/ lifetime_histograms extendable_histograms<T>::snapshot() {
+    lifetime_histograms result;
+
+    auto& registry = all_threads();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& thread : registry.threads) {
+        thread->hold_ns.merge_into(result.hold_ns);
+        thread->destruction_delay_ns.merge_into(result.destruction_delay_ns);
+    }
+    return result;
+}
+
+template <typename T>
+/*static*/ void extendable_histograms<T>::record_hold(std::int64_t nanoseconds) {
+    this_thread().hold_ns.record(static_cast<std::uint64_t>(std::max<std::int64_t>(nanoseconds, 0)));
+}
+
+template <typename T>
+/*static*/ void extendable_histograms<T>::record_destruction_delay(std::int64_t nanoseconds) {
+    this_thread().destruction_delay_ns.record(
+        static_cast<std::uint64_t>(std::max<std::int64_t>(nanoseconds, 0)));
+}
+
+template <typename T>
+/*static*/ typename extendable_histograms<T>::registry& extendable_histograms<T>::all_threads() {
+    static registry instance;
+    return instance;
+}
+
+template <typename T>
+/*static*/ typename extendable_histograms<T>::thread_histograms& extendable_histograms<T>::this_thread() {
+    static thread_local std::shared_ptr<thread_histograms> histograms = [] {
+        auto created = std::make_shared<thread_histograms>();
+        auto& registry = all_threads();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(created);
+        return created;
+    }();
+    return *histograms;
+}
+
+#endif // _EXTENDABLE_LIFETIME_HISTOGRAMS_IMPL_
@@ -0,0 +1,143 @@
+#ifndef _EXTENDABLE_LONG_HOLD_DETECTOR_
+#define _EXTENDABLE_LONG_HOLD_DETECTOR_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Information about a @see scoped_extender that has been alive for
+ * longer than the threshold of the @see long_hold_detector
+ */
+struct long_hold_report {
+    const char* type_name;
+    const char* file_name;
+    const char* function_name;
+    std::uint_least32_t line;
+    std::thread::id thread;
+    std::chrono::nanoseconds held_for;
+};
+
+/**
+ * @brief Watchdog that reports scoped_extender-s which extend a resource for
+ * too long, enabled by EXTENDABLE_ENABLE_LONG_HOLD_DETECTION (requires C++20)
+ * @details Every successful weak_extender::lock() registers the produced
+ * scoped_extender together with the call site of lock() in a table owned by
+ * the calling thread. A watchdog thread periodically scans the tables of all
+ * threads and reports every scoped_extender that is alive for longer than the
+ * threshold, once per scoped_extender.
+ *
+ * Registration is a clock read, a few stores into memory owned by the
+ * calling thread and a reference to its table, so the detector is cheap
+ * enough to stay enabled in non-shipping builds. The reference lets a
+ * scoped_extender that is released on another thread (e.g. by a coroutine
+ * resumed elsewhere) end the hold in the table it was registered in. Each
+ * thread tracks up to max_holds_per_thread simultaneously alive
+ * scoped_extender-s, the rest are counted in untracked_holds().
+ */
+class long_hold_detector {
+public:
+    static constexpr std::size_t max_holds_per_thread = 64;
+    static constexpr int untracked = -1;
+
+    using report_callback = std::function<void(const long_hold_report&)>;
+
+    /**
+     * @brief Holds registered by a single thread
+     */
+    struct thread_table;
+
+    /**
+     * @brief Starts the watchdog thread, the default callback prints reports
+     * to stderr. Does nothing if the watchdog is already running.
+     */
+    static void start(
+        std::chrono::nanoseconds threshold,
+        std::chrono::nanoseconds scan_period = std::chrono::milliseconds(10),
+        report_callback = nullptr);
+    static void stop();
+
+    static std::uint64_t untracked_holds();
+
+    /**
+     * @brief Registers a hold in the table of the calling thread
+     * @param table Set to the table of the calling thread if the hold is tracked
+     * @return Index of the slot to be passed to end_hold(), or @see untracked
+     */
+    static int begin_hold(
+        std::shared_ptr<thread_table>& table, const std::source_location&, const char* type_name);
+    /**
+     * @brief Ends the hold in the table it was registered in, may be called
+     * on any thread
+     */
+    static void end_hold(const std::shared_ptr<thread_table>& table, int slot);
+
+private:
+    /**
+     * @details The call site is written before start_ns with release stores
+     * and read after it with acquire loads, so a scan that sees the call site
+     * of a newer hold also sees start_ns changed when it checks it again
+     */
+    struct slot {
+        std::atomic<std::int64_t> start_ns{0};
+        std::atomic<const char*> type_name{nullptr};
+        std::atomic<const char*> file_name{nullptr};
+        std::atomic<const char*> function_name{nullptr};
+        std::atomic<std::uint_least32_t> line{0};
+        /**
+         * @brief Accessed only by the watchdog thread
+         */
+        std::int64_t reported_start_ns = 0;
+    };
+
+    struct thread_table_owner {
+        thread_table_owner();
+        ~thread_table_owner();
+        std::shared_ptr<thread_table> table;
+    };
+
+    struct state {
+        /**
+         * @brief Stops the watchdog thread if it is still running, so that
+         * exiting without stop() does not terminate the process
+         */
+        ~state();
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_table>> tables;
+        std::atomic<std::uint64_t> untracked_holds{0};
+
+        std::mutex watchdog_mutex;
+        std::condition_variable watchdog_wake;
+        std::thread watchdog;
+        bool stopping = false;
+    };
+
+    static state& global();
+    static const std::shared_ptr<thread_table>& this_thread_table();
+    static void scan(std::chrono::nanoseconds threshold, const report_callback&);
+};
+
+struct long_hold_detector::thread_table {
+    std::thread::id thread = std::this_thread::get_id();
+    std::atomic<bool> thread_alive{true};
+    /**
+     * @brief Slots below this index may be in use, accessed only by the
+     * owning thread. The slots freed by other threads stay below it until
+     * the owning thread frees the last slot.
+     */
+    std::size_t used = 0;
+    std::array<slot, max_holds_per_thread> slots;
+};
+
+#include "extendable_long_hold_detector_impl.h"
+
+#endif // _EXTENDABLE_LONG_HOLD_DETECTOR_
@@ -0,0 +1,174 @@
+#ifndef _EXTENDABLE_LONG_HOLD_DETECTOR_IMPL_
+#define _EXTENDABLE_LONG_HOLD_DETECTOR_IMPL_
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+inline /*static*/ void long_hold_detector::start(
+    std::chrono::nanoseconds threshold,
+    std::chrono::nanoseconds scan_period,
+    report_callback callback) {
+    if (!callback) {
+        callback = [](const long_hold_report& report) {
+            std::ostringstream thread;
+            thread << report.thread;
+            std::fprintf(stderr,
+                "scoped_extender<%s> held for %lld us by thread %s, locked at %s:%u (%s)\n",
+                report.type_name,
+                static_cast<long long>(report.held_for.count() / 1000),
+                thread.str().c_str(),
+                report.file_name,
+                static_cast<unsigned>(report.line),
+                report.function_name);
+        };
+    }
+
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.watchdog_mutex);
+    if (state.watchdog.joinable()) {
+        return;
+    }
+    state.stopping = false;
+    state.watchdog = std::thread([threshold, scan_period, callback = std::move(callback)] {
+        auto& state = global();
+        std::unique_lock<std::mutex> lock(state.watchdog_mutex);
+        while (!state.watchdog_wake.wait_for(lock, scan_period, [&] { return state.stopping; })) {
+            lock.unlock();
+            scan(threshold, callback);
+            lock.lock();
+        }
+    });
+}
+
+inline /*static*/ void long_hold_detector::stop() {
+    auto& state = global();
+    std::thread watchdog;
+    {
+        std::lock_guard<std::mutex> lock(state.watchdog_mutex);
+        state.stopping = true;
+        watchdog = std::move(state.watchdog);
+    }
+    state.watchdog_wake.notify_all();
+    if (watchdog.joinable()) {
+        watchdog.join();
+    }
+}
+
+inline /*static*/ std::uint64_t long_hold_detector::untracked_holds() {
+    return global().untracked_holds.load(std::memory_order_relaxed);
+}
+
+inline /*static*/ int long_hold_detector::begin_hold(
+    std::shared_ptr<thread_table>& owner, const std::source_location& call_site, const char* type_name) {
+    const auto& owned = this_thread_table();
+    auto& table = *owned;
+
+    std::size_t index = 0;
+    while (index < table.used && table.slots[index].start_ns.load(std::memory_order_relaxed) != 0) {
+        ++index;
+    }
+    if (index == max_holds_per_thread) {
+        global().untracked_holds.fetch_add(1, std::memory_order_relaxed);
+        return untracked;
+    }
+    table.used = std::max(table.used, index + 1);
+
+    auto& slot = table.slots[index];
+    slot.type_name.store(type_name, std::memory_order_release);
+    slot.file_name.store(call_site.file_name(), std::memory_order_release);
+    slot.function_name.store(call_site.function_name(), std::memory_order_release);
+    slot.line.store(call_site.line(), std::memory_order_release);
+    // 0 marks a free slot
+    slot.start_ns.store(std::max<std::int64_t>(instrumentation_clock_ns(), 1), std::memory_order_release);
+    owner = owned;
+    return static_cast<int>(index);
+}
+
+inline /*static*/ void long_hold_detector::end_hold(const std::shared_ptr<thread_table>& table, int slot) {
+    if (slot == untracked) {
+        return;
+    }
+    table->slots[slot].start_ns.store(0, std::memory_order_release);
+    // a dead thread's id may have been reused by the calling thread
+    if (table->thread != std::this_thread::get_id() || !table->thread_alive.load(std::memory_order_relaxed)) {
+        return;
+    }
+    while (table->used != 0 && table->slots[table->used - 1].start_ns.load(std::memory_order_relaxed) == 0) {
+        --table->used;
+    }
+}
+
+inline long_hold_detector::thread_table_owner::thread_table_owner()
+    : table(std::make_shared<thread_table>()) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.tables.push_back(table);
+}
+
+inline long_hold_detector::thread_table_owner::~thread_table_owner() {
+    table->thread_alive.store(false, std::memory_order_release);
+}
+
+inline long_hold_detector::state::~state() {
+    {
+        std::lock_guard<std::mutex> lock(watchdog_mutex);
+        stopping = true;
+    }
+    watchdog_wake.notify_all();
+    if (watchdog.joinable()) {
+        watchdog.join();
+    }
+}
+
+inline /*static*/ long_hold_detector::state& long_hold_detector::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ const std::shared_ptr<long_hold_detector::thread_table>& long_hold_detector::this_thread_table() {
+    static thread_local thread_table_owner owner;
+    return owner.table;
+}
+
+inline /*static*/ void long_hold_detector::scan(
+    std::chrono::nanoseconds threshold, const report_callback& callback) {
+    std::vector<std::shared_ptr<thread_table>> tables;
+    {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.tables.erase(
+            std::remove_if(state.tables.begin(), state.tables.end(), [](const auto& table) {
+                return !table->thread_alive.load(std::memory_order_acquire);
+            }),
+            state.tables.end());
+        tables = state.tables;
+    }
+
+    const auto now = instrumentation_clock_ns();
+    for (const auto& table : tables) {
+        for (auto& slot : table->slots) {
+            const auto start = slot.start_ns.load(std::memory_order_acquire);
+            if (start == 0 || start == slot.reported_start_ns || now - start < threshold.count()) {
+                continue;
+            }
+
+            long_hold_report report;
+            report.type_name = slot.type_name.load(std::memory_order_acquire);
+            report.file_name = slot.file_name.load(std::memory_order_acquire);
+            report.function_name = slot.function_name.load(std::memory_order_acquire);
+            report.line = slot.line.load(std::memory_order_acquire);
+            report.thread = table->thread;
+            report.held_for = std::chrono::nanoseconds(now - start);
+
+            // the slot could have been reused while it was being read
+            if (slot.start_ns.load(std::memory_order_relaxed) != start) {
+                continue;
+            }
+            slot.reported_start_ns = start;
+            callback(report);
+        }
+    }
+}
+
+#endif // _EXTENDABLE_LONG_HOLD_DETECTOR_IMPL_
@@ -0,0 +1,120 @@
+#ifndef _EXTENDABLE_PARALLEL_
+#define _EXTENDABLE_PARALLEL_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+
+#include "extendable_thread_pool.h"
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Calls the function with every live resource of the storage, splitting
+ * the storage into chunks that are processed by the workers of the pool and
+ * by the calling thread
+ * @details The chunks are claimed one by one from a shared counter, so
+ * a worker that is done with its chunk takes over the next one instead of
+ * waiting for the slowest one. Every chunk is processed inside an
+ * @see extension_scope opened by the thread that claimed it, so the
+ * resources of the chunk are not destroyed until the chunk is done, and an
+ * element costs no reference counting at all.
+ *
+ * The storage may hold @see weak_extender-s, in which case the owners may
+ * reset the resources concurrently: a resource marked for destruction before
+ * its element is reached is skipped. A storage of unique_extendable_ptr-s
+ * is read directly, so as with any container it must not be modified until
+ * the call returns, empty elements are skipped.
+ *
+ * Returns once every chunk is done. The calling thread takes part, so it may
+ * also be a worker of the pool. If the function throws, the remaining chunks
+ * are still processed and the first exception is rethrown.
+ *
+ * @param range Random access range of weak_extender-s or unique_extendable_ptr-s
+ * @param function Is called as function(T&) concurrently from several threads
+ * @param chunk_size Number of elements per chunk, 0 picks a few chunks per
+ * thread
+ */
+template <typename Range, typename Function>
+void parallel_for_each(
+    work_stealing_pool& pool, const Range& range, Function function, std::size_t chunk_size = 0);
+
+/**
+ * @brief Resets every unique_extendable_ptr of the storage the same way as
+ * @see reset_all(Range&), but releases the resources in chunks on the
+ * workers of the pool and on the calling thread
+ * @details The resources are marked for destruction by the calling thread in
+ * one pass followed by a single fence, so none of them is accessible by the
+ * time the first one is destroyed. Only the release and the destruction,
+ * i.e. the expensive part, are spread over the pool. The storage must not be
+ * modified until the call returns.
+ *
+ * @param range Random access range of unique_extendable_ptr-s
+ * @param chunk_size Number of elements per chunk, 0 picks a few chunks per
+ * thread
+ */
+template <typename Range>
+bulk_reset_result reset_all(work_stealing_pool& pool, Range& range, std::size_t chunk_size = 0);
+
+/**
+ * @brief parallel_for_each() and the parallel reset_all() internal state
+ * shared by the threads that process the chunks
+ * @tparam ChunkFunction Is called as function(begin, end) with the indices of
+ * the elements of a chunk
+ */
+template <typename ChunkFunction>
+class parallel_chunks {
+public:
+    parallel_chunks(std::size_t size, std::size_t chunk_size, ChunkFunction& function);
+
+    std::size_t chunk_count() const;
+
+    /**
+     * @brief Claims and processes chunks until there are none left
+     */
+    void run();
+    /**
+     * @brief Blocks until every chunk is done, rethrows the first exception
+     * thrown by the function
+     */
+    void wait();
+
+    /**
+     * @brief Runs the chunks on the pool and on the calling thread, returns
+     * once all of them are done
+     */
+    static void run_on(work_stealing_pool&, std::size_t size, std::size_t chunk_size, ChunkFunction&);
+
+private:
+    std::size_t size;
+    std::size_t chunk_size;
+    /**
+     * @brief Is dereferenced only for a claimed chunk, i.e. before wait()
+     * returns
+     */
+    ChunkFunction* function;
+
+    std::atomic<std::size_t> next_chunk{0};
+    std::atomic<std::size_t> done_chunks{0};
+
+    std::mutex mutex;
+    std::condition_variable all_done;
+    std::exception_ptr error;
+};
+
+/**
+ * @brief parallel_for_each() internal access to the elements of the storage
+ */
+struct parallel_element {
+    template <typename T>
+    static T* resource(const weak_extender<T>&, const extension_scope&);
+    template <typename T>
+    static T* resource(const unique_extendable_ptr<T>&, const extension_scope&);
+};
+
+#include "extendable_parallel_impl.h"
+
+#endif // _EXTENDABLE_PARALLEL_
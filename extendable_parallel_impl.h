@@ -0,0 +1,145 @@
+#ifndef _EXTENDABLE_PARALLEL_IMPL_
+#define _EXTENDABLE_PARALLEL_IMPL_
+
+#include <algorithm>
+
+template <typename ChunkFunction>
+parallel_chunks<ChunkFunction>::parallel_chunks(
+    std::size_t size, std::size_t chunk_size, ChunkFunction& function)
+    : size(size)
+    , chunk_size(chunk_size)
+    , function(&function) {}
+
+template <typename ChunkFunction>
+std::size_t parallel_chunks<ChunkFunction>::chunk_count() const {
+    return (size + chunk_size - 1) / chunk_size;
+}
+
+template <typename ChunkFunction>
+void parallel_chunks<ChunkFunction>::run() {
+    for (;;) {
+        const auto chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= chunk_count()) {
+            return;
+        }
+        try {
+            const auto begin = chunk * chunk_size;
+            (*function)(begin, std::min(begin + chunk_size, size));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error == nullptr) {
+                error = std::current_exception();
+            }
+        }
+        if (done_chunks.fetch_add(1, std::memory_order_acq_rel) + 1 == chunk_count()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            all_done.notify_all();
+        }
+    }
+}
+
+template <typename ChunkFunction>
+void parallel_chunks<ChunkFunction>::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [this] { return done_chunks.load(std::memory_order_acquire) == chunk_count(); });
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename ChunkFunction>
+/*static*/ void parallel_chunks<ChunkFunction>::run_on(
+    work_stealing_pool& pool, std::size_t size, std::size_t chunk_size, ChunkFunction& function) {
+    if (chunk_size == 0) {
+        // a few chunks per thread let the ones that finish early take over
+        // the remaining work of the slow ones
+        const auto threads = pool.size() + 1;
+        chunk_size = std::max<std::size_t>(1, size / (threads * 8));
+    }
+
+    auto chunks = std::make_shared<parallel_chunks>(size, chunk_size, function);
+    // the helpers that start after the last chunk was claimed only look at
+    // the counter, so the shared state is the only thing they keep alive
+    const auto helpers = std::min(pool.size(), chunks->chunk_count() - 1);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        pool.submit([chunks] { chunks->run(); });
+    }
+    chunks->run();
+    chunks->wait();
+}
+
+
+template <typename T>
+/*static*/ T* parallel_element::resource(const weak_extender<T>& extender, const extension_scope& scope) {
+    // the scope keeps the resource alive after the scoped_extender is gone
+    return extender.lock(scope).get();
+}
+
+template <typename T>
+/*static*/ T* parallel_element::resource(const unique_extendable_ptr<T>& owner, const extension_scope&) {
+    return owner ? owner.get() : nullptr;
+}
+
+
+template <typename Range, typename Function>
+void parallel_for_each(
+    work_stealing_pool& pool, const Range& range, Function function, std::size_t chunk_size) {
+    using std::begin;
+    using std::end;
+    using difference_type = typename std::iterator_traits<decltype(begin(range))>::difference_type;
+
+    const auto first = begin(range);
+    const auto size = static_cast<std::size_t>(std::distance(first, end(range)));
+    if (size == 0) {
+        return;
+    }
+
+    auto run_chunk = [&](std::size_t chunk_begin, std::size_t chunk_end) {
+        const auto& scope = extension_scope::open();
+        auto it = first + static_cast<difference_type>(chunk_begin);
+        for (auto index = chunk_begin; index != chunk_end; ++index, ++it) {
+            auto* found = parallel_element::resource(*it, scope);
+            if (found != nullptr) {
+                function(*found);
+            }
+        }
+    };
+    parallel_chunks<decltype(run_chunk)>::run_on(pool, size, chunk_size, run_chunk);
+}
+
+template <typename Range>
+bulk_reset_result reset_all(work_stealing_pool& pool, Range& range, std::size_t chunk_size) {
+    using std::begin;
+    using std::end;
+    using difference_type = typename std::iterator_traits<decltype(begin(range))>::difference_type;
+
+    const auto first = begin(range);
+    const auto last = end(range);
+    bulk_reset_result result;
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (size == 0) {
+        return result;
+    }
+
+    bulk_reset::mark(first, last);
+    // publishes all the marks before any of the resources is released
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bulk_reset::notify(first, last);
+
+    std::atomic<std::size_t> reset{0};
+    std::atomic<std::size_t> deferred{0};
+    auto release_chunk = [&](std::size_t chunk_begin, std::size_t chunk_end) {
+        const auto released = bulk_reset::release(
+            first + static_cast<difference_type>(chunk_begin),
+            first + static_cast<difference_type>(chunk_end));
+        reset.fetch_add(released.reset, std::memory_order_relaxed);
+        deferred.fetch_add(released.deferred, std::memory_order_relaxed);
+    };
+    parallel_chunks<decltype(release_chunk)>::run_on(pool, size, chunk_size, release_chunk);
+
+    result.reset = reset.load(std::memory_order_relaxed);
+    result.deferred = deferred.load(std::memory_order_relaxed);
+    return result;
+}
+
+#endif // _EXTENDABLE_PARALLEL_IMPL_
@@ -0,0 +1,104 @@
+#ifndef _EXTENDABLE_REAL_TIME_
+#define _EXTENDABLE_REAL_TIME_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Marks the calling thread as a real-time one (audio, rendering) for as
+ * long as the object is alive
+ * @details A real-time thread never destroys a resource or frees a control
+ * block in place: both are handed over through a preallocated lock-free ring
+ * to reclaim(), which is expected to be called periodically by another thread.
+ * Together with weak_extender::lock(const real_time_thread&) it gives the
+ * thread a wait-free access to the resources: the lock pins the resource with
+ * a single atomic increment, the release is a single decrement, and neither
+ * of them ever allocates, frees or blocks. A lock inside an
+ * @see extension_scope is two atomic loads, opening and closing the scope
+ * writes only to a record of the thread, which is allocated by the first scope
+ * the thread opens, so it should open one before entering its real-time loop.
+ *
+ * weak_extender::lock() without an argument relies on std::weak_ptr::lock(),
+ * which is a CAS loop, and registers the lock for the nested ones, which may
+ * allocate, so a real-time thread should not use it.
+ *
+ * The work that does not fit into the ring is done in place and counted in
+ * overflows().
+ */
+class real_time_thread {
+public:
+    static constexpr std::size_t default_capacity = 4096;
+
+    using deferred_work = void (*)(void* pointer, std::size_t size);
+
+    /**
+     * @brief Allocates the ring of the calling thread, should be constructed
+     * before the thread enters its real-time loop
+     */
+    explicit real_time_thread(std::size_t capacity = default_capacity);
+    /**
+     * @brief Unmarks the thread, the work that is still in its ring is done
+     * by the following reclaim() calls
+     */
+    ~real_time_thread();
+
+    real_time_thread(const real_time_thread&) = delete;
+    real_time_thread& operator=(const real_time_thread&) = delete;
+    real_time_thread(real_time_thread&&) = delete;
+    real_time_thread& operator=(real_time_thread&&) = delete;
+
+    static bool current();
+
+    /**
+     * @brief Hands the work over to reclaim() if the calling thread is
+     * a real-time one
+     * @return false if the work should be done in place by the caller
+     */
+    static bool try_hand_off(deferred_work, void* pointer, std::size_t size);
+    /**
+     * @brief Does the work handed over by all the real-time threads so far
+     * @return Number of the pieces of work done
+     */
+    static std::size_t reclaim();
+    static std::uint64_t overflows();
+
+private:
+    struct work {
+        deferred_work function;
+        void* pointer;
+        std::size_t size;
+    };
+
+    /**
+     * @brief Single-producer single-consumer ring, the producer is the
+     * real-time thread and the consumer is reclaim() under the state mutex
+     */
+    struct work_ring {
+        explicit work_ring(std::size_t capacity);
+
+        std::vector<work> slots;
+        std::atomic<std::size_t> head{0};
+        std::atomic<std::size_t> tail{0};
+        std::atomic<bool> thread_alive{true};
+    };
+
+    struct state {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<work_ring>> rings;
+        std::atomic<std::uint64_t> overflows{0};
+    };
+
+    static state& global();
+    static work_ring*& this_thread_ring();
+
+    std::shared_ptr<work_ring> ring;
+    work_ring* previous;
+};
+
+#include "extendable_real_time_impl.h"
+
+#endif // _EXTENDABLE_REAL_TIME_
@@ -0,0 +1,82 @@
+#ifndef _EXTENDABLE_REAL_TIME_IMPL_
+#define _EXTENDABLE_REAL_TIME_IMPL_
+
+inline real_time_thread::work_ring::work_ring(std::size_t capacity)
+    : slots(capacity > 0 ? capacity : 1) {}
+
+inline real_time_thread::real_time_thread(std::size_t capacity)
+    : ring(std::make_shared<work_ring>(capacity))
+    , previous(this_thread_ring()) {
+    auto& state = global();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.rings.push_back(ring);
+    }
+    this_thread_ring() = ring.get();
+}
+
+inline real_time_thread::~real_time_thread() {
+    this_thread_ring() = previous;
+    ring->thread_alive.store(false, std::memory_order_release);
+}
+
+inline /*static*/ bool real_time_thread::current() {
+    return this_thread_ring() != nullptr;
+}
+
+inline /*static*/ bool real_time_thread::try_hand_off(
+    deferred_work function, void* pointer, std::size_t size) {
+    auto* local = this_thread_ring();
+    if (local == nullptr) {
+        return false;
+    }
+    const auto head = local->head.load(std::memory_order_relaxed);
+    if (head - local->tail.load(std::memory_order_acquire) == local->slots.size()) {
+        global().overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    local->slots[head % local->slots.size()] = work{function, pointer, size};
+    local->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+inline /*static*/ std::size_t real_time_thread::reclaim() {
+    auto& state = global();
+    std::vector<work> pending;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (auto it = state.rings.begin(); it != state.rings.end();) {
+            auto& ring = **it;
+            // read before the head, so a dead ring is dropped only once drained
+            const bool thread_alive = ring.thread_alive.load(std::memory_order_acquire);
+            const auto head = ring.head.load(std::memory_order_acquire);
+            auto tail = ring.tail.load(std::memory_order_relaxed);
+            for (; tail != head; ++tail) {
+                pending.push_back(ring.slots[tail % ring.slots.size()]);
+            }
+            ring.tail.store(tail, std::memory_order_release);
+            it = thread_alive ? it + 1 : state.rings.erase(it);
+        }
+    }
+    // done outside of the lock, since destructors may hand over more work
+    for (const auto& piece : pending) {
+        piece.function(piece.pointer, piece.size);
+    }
+    return pending.size();
+}
+
+inline /*static*/ std::uint64_t real_time_thread::overflows() {
+    return global().overflows.load(std::memory_order_relaxed);
+}
+
+inline /*static*/ real_time_thread::state& real_time_thread::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ real_time_thread::work_ring*& real_time_thread::this_thread_ring() {
+    static thread_local work_ring* local = nullptr;
+    return local;
+}
+
+#endif // _EXTENDABLE_REAL_TIME_IMPL_
@@ -0,0 +1,126 @@
+#ifndef _EXTENDABLE_REGISTRY_
+#define _EXTENDABLE_REGISTRY_
+
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Owns a dynamic set of resources and publishes immutable snapshots of
+ * @see weak_extender-s to them for readers in other threads
+ * @details The owner inserts and erases resources at any time, but readers
+ * see only what the last publish() published, typically once per frame.
+ * A snapshot is a contiguous array that does not change while it is read, so
+ * readers iterate it without any lock and without being affected by the
+ * concurrent inserts and erases. Whether a resource of the snapshot is still
+ * alive is decided per element by locking its weak_extender, the same as
+ * anywhere else: an erased resource is marked for destruction right away.
+ *
+ * There are two snapshot buffers: readers take the one that was published
+ * last, publish() fills the other one and swaps them. Readers only increment
+ * and decrement a counter of the buffer, publish() waits for the readers of
+ * the buffer it is about to fill, i.e. for the ones that still read the
+ * snapshot published two calls ago.
+ *
+ * Inserting, erasing and publishing is reserved for a single owner thread.
+ *
+ * @tparam T Type of the owned resources
+ */
+template <typename T>
+class extendable_registry {
+public:
+    class snapshot;
+
+    extendable_registry() = default;
+
+    extendable_registry(const extendable_registry&) = delete;
+    extendable_registry& operator=(const extendable_registry&) = delete;
+
+    /**
+     * @brief Takes over the resource, readers see it after the next publish()
+     */
+    weak_extender<T> insert(unique_extendable_ptr<T>);
+    /**
+     * @brief Resets the resource, which is no longer accessible through any
+     * snapshot right away and disappears from them after the next publish()
+     * @return false if the resource is not owned by the registry
+     */
+    bool erase(const weak_extender<T>&);
+    /**
+     * @brief Number of the resources owned right now, not necessarily
+     * published yet
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Makes the inserts and erases done so far visible to the readers
+     * @details Does nothing if nothing changed since the last call. Otherwise
+     * waits until nobody reads the snapshot published two calls ago, so
+     * a reader should not hold a snapshot across two publish() calls.
+     */
+    void publish();
+
+    /**
+     * @brief Returns the snapshot published last, may be called from any
+     * thread
+     */
+    snapshot read() const;
+
+private:
+    struct alignas(64) buffer {
+        std::vector<weak_extender<T>> extenders;
+        std::size_t version = 0;
+        mutable std::atomic<std::size_t> readers{0};
+    };
+
+    std::vector<unique_extendable_ptr<T>> owners;
+    /**
+     * @brief Mirrors owners, is copied into the buffers by publish()
+     */
+    std::vector<weak_extender<T>> extenders;
+    /**
+     * @brief Index of every resource in owners, keyed by weak_extender::owner()
+     */
+    std::unordered_map<const void*, std::size_t> indices;
+    std::size_t version = 0;
+
+    buffer buffers[2];
+    std::atomic<std::size_t> current{0};
+};
+
+/**
+ * @brief Contiguous array of @see weak_extender-s published by
+ * extendable_registry::publish()
+ * @details Same as @see scoped_extender it is uncopyable and unmovable, may be
+ * retrieved only by extendable_registry::read() and may be caught only by
+ * const reference, so that it is held only while it is iterated.
+ */
+template <typename T>
+class extendable_registry<T>::snapshot {
+public:
+    ~snapshot();
+
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+    snapshot& operator=(snapshot&&) = delete;
+
+    const weak_extender<T>* begin() const;
+    const weak_extender<T>* end() const;
+    std::size_t size() const;
+    const weak_extender<T>& operator[](std::size_t) const;
+
+private:
+    friend class extendable_registry<T>;
+
+    explicit snapshot(const buffer&);
+    snapshot(snapshot&&);
+
+    const buffer* read;
+};
+
+#include "extendable_registry_impl.h"
+
+#endif // _EXTENDABLE_REGISTRY_
@@ -0,0 +1,114 @@
+#ifndef _EXTENDABLE_REGISTRY_IMPL_
+#define _EXTENDABLE_REGISTRY_IMPL_
+
+#include <thread>
+#include <utility>
+
+template <typename T>
+weak_extender<T> extendable_registry<T>::insert(unique_extendable_ptr<T> owner) {
+    weak_extender<T> extender(owner);
+    indices.emplace(extender.owner(), owners.size());
+    owners.push_back(std::move(owner));
+    extenders.push_back(extender);
+    ++version;
+    return extender;
+}
+
+template <typename T>
+bool extendable_registry<T>::erase(const weak_extender<T>& extender) {
+    auto found = indices.find(extender.owner());
+    if (found == indices.end()) {
+        return false;
+    }
+    const auto index = found->second;
+    indices.erase(found);
+    owners[index].reset();
+
+    // keeps the storage dense
+    if (index + 1 != owners.size()) {
+        owners[index] = std::move(owners.back());
+        extenders[index] = std::move(extenders.back());
+        indices[extenders[index].owner()] = index;
+    }
+    owners.pop_back();
+    extenders.pop_back();
+    ++version;
+    return true;
+}
+
+template <typename T>
+std::size_t extendable_registry<T>::size() const {
+    return owners.size();
+}
+
+template <typename T>
+void extendable_registry<T>::publish() {
+    const auto published = current.load(std::memory_order_relaxed);
+    if (buffers[published].version == version) {
+        return;
+    }
+    auto& next = buffers[1 - published];
+    // pairs with the validation in read(): a reader that comes after this
+    // load sees the old index and backs off
+    while (next.readers.load() != 0) {
+        std::this_thread::yield();
+    }
+    // reuses the capacity of the buffer
+    next.extenders = extenders;
+    next.version = version;
+    current.store(1 - published);
+}
+
+template <typename T>
+typename extendable_registry<T>::snapshot extendable_registry<T>::read() const {
+    for (;;) {
+        const auto index = current.load();
+        const auto& candidate = buffers[index];
+        candidate.readers.fetch_add(1);
+        // the buffer may have been taken for the next publish() in the meantime
+        if (current.load() == index) {
+            return snapshot(candidate);
+        }
+        candidate.readers.fetch_sub(1);
+    }
+}
+
+
+template <typename T>
+extendable_registry<T>::snapshot::snapshot(const buffer& read)
+    : read(&read) {}
+
+template <typename T>
+extendable_registry<T>::snapshot::snapshot(snapshot&& other)
+    : read(other.read) {
+    other.read = nullptr;
+}
+
+template <typename T>
+extendable_registry<T>::snapshot::~snapshot() {
+    if (read != nullptr) {
+        read->readers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+template <typename T>
+const weak_extender<T>* extendable_registry<T>::snapshot::begin() const {
+    return read->extenders.data();
+}
+
+template <typename T>
+const weak_extender<T>* extendable_registry<T>::snapshot::end() const {
+    return read->extenders.data() + read->extenders.size();
+}
+
+template <typename T>
+std::size_t extendable_registry<T>::snapshot::size() const {
+    return read->extenders.size();
+}
+
+template <typename T>
+const weak_extender<T>& extendable_registry<T>::snapshot::operator[](std::size_t index) const {
+    return read->extenders[index];
+}
+
+#endif // _EXTENDABLE_REGISTRY_IMPL_
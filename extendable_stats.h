@@ -0,0 +1,120 @@
+#ifndef _EXTENDABLE_STATS_
+#define _EXTENDABLE_STATS_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Values of the @see extendable_stats counters for a single type
+ */
+struct extendable_stats_snapshot {
+    /**
+     * @brief weak_extender::lock() calls that produced a non-empty
+     * scoped_extender, including the nested ones that borrow the reference of
+     * an enclosing scoped_extender and the ones inside an extension_scope
+     * @details lock(real_time_thread) is not counted, counting would allocate
+     * the shard of a thread that must not allocate
+     */
+    std::uint64_t lock_hits = 0;
+    /**
+     * @brief weak_extender::lock() calls that produced an empty
+     * scoped_extender, including the ones on a resource whose asynchronous
+     * construction is still running or has failed
+     */
+    std::uint64_t lock_misses = 0;
+    /**
+     * @brief Misses in which the resource was still alive but already marked
+     * for destruction, i.e. lock() raced with unique_extendable_ptr::reset()
+     * or lost to a scoped_extender that outlived the owner
+     */
+    std::uint64_t lock_reset_races = 0;
+    /**
+     * @brief scoped_extender-s that were released after the owning
+     * unique_extendable_ptr had been reset
+     */
+    std::uint64_t outlived_owner = 0;
+};
+
+/**
+ * @brief Per-type counters of lock() outcomes and of extenders outliving
+ * their owners, enabled by EXTENDABLE_ENABLE_STATS
+ * @details Every thread increments its own cache-line sized shard of
+ * counters with plain relaxed stores, so counting involves no contended or
+ * read-modify-write atomics. Shards are summed only when a snapshot is
+ * requested and outlive the threads that filled them.
+ *
+ * Note that the retries of the compare-and-swap loop inside
+ * std::weak_ptr::lock() are not observable from the outside, lock_reset_races
+ * is the closest contention signal available.
+ *
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+class extendable_stats {
+public:
+    static extendable_stats_snapshot snapshot();
+
+    static void count_lock_hit();
+    static void count_lock_miss(bool raced_with_reset);
+    static void count_outlived_owner();
+
+private:
+    struct alignas(64) shard {
+        std::atomic<std::uint64_t> lock_hits{0};
+        std::atomic<std::uint64_t> lock_misses{0};
+        std::atomic<std::uint64_t> lock_reset_races{0};
+        std::atomic<std::uint64_t> outlived_owner{0};
+    };
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<shard>> shards;
+    };
+
+    static registry& all_shards();
+    static shard& this_thread_shard();
+    /**
+     * @brief Increment by the only thread that writes the counter
+     */
+    static void increment(std::atomic<std::uint64_t>&);
+};
+
+/**
+ * @brief Writes the counters of every type that has counted anything in a
+ * text exposition format understood by Prometheus-style scrapers
+ */
+class extendable_stats_exposition {
+public:
+    static void write(std::ostream&);
+    /**
+     * @return false if the file could not be written
+     */
+    static bool dump(const char* path);
+
+    /**
+     * @brief Called once per type by @see extendable_stats
+     */
+    static void register_type(const char* type_name, std::function<extendable_stats_snapshot()>);
+
+private:
+    struct registered_type {
+        const char* type_name;
+        std::function<extendable_stats_snapshot()> snapshot;
+    };
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<registered_type> types;
+    };
+
+    static registry& all_types();
+};
+
+#include "extendable_stats_impl.h"
+
+#endif // _EXTENDABLE_STATS_
@@ -0,0 +1,125 @@
+#ifndef _EXTENDABLE_STATS_IMPL_
+#define _EXTENDABLE_STATS_IMPL_
+
+#include <fstream>
+#include <typeinfo>
+
+template <typename T>
+/*static*/ extendable_stats_snapshot extendable_stats<T>::snapshot() {
+    extendable_stats_snapshot result;
+
+    auto& registry = all_shards();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& shard : registry.shards) {
+        result.lock_hits += shard->lock_hits.load(std::memory_order_relaxed);
+        result.lock_misses += shard->lock_misses.load(std::memory_order_relaxed);
+        result.lock_reset_races += shard->lock_reset_races.load(std::memory_order_relaxed);
+        result.outlived_owner += shard->outlived_owner.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+template <typename T>
+/*static*/ void extendable_stats<T>::count_lock_hit() {
+    increment(this_thread_shard().lock_hits);
+}
+
+template <typename T>
+/*static*/ void extendable_stats<T>::count_lock_miss(bool raced_with_reset) {
+    auto& shard = this_thread_shard();
+    increment(shard.lock_misses);
+    if (raced_with_reset) {
+        increment(shard.lock_reset_races);
+    }
+}
+
+template <typename T>
+/*static*/ void extendable_stats<T>::count_outlived_owner() {
+    increment(this_thread_shard().outlived_owner);
+}
+
+template <typename T>
+/*static*/ typename extendable_stats<T>::registry& extendable_stats<T>::all_shards() {
+    static registry instance;
+    return instance;
+}
+
+template <typename T>
+/*static*/ typename extendable_stats<T>::shard& extendable_stats<T>::this_thread_shard() {
+    static thread_local std::shared_ptr<shard> local = [] {
+        auto created = std::make_shared<shard>();
+        auto& registry = all_shards();
+        bool first = false;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            first = registry.shards.empty();
+            registry.shards.push_back(created);
+        }
+        if (first) {
+            extendable_stats_exposition::register_type(typeid(T).name(), &snapshot);
+        }
+        return created;
+    }();
+    return *local;
+}
+
+template <typename T>
+/*static*/ void extendable_stats<T>::increment(std::atomic<std::uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+inline /*static*/ void extendable_stats_exposition::write(std::ostream& out) {
+    std::vector<registered_type> types;
+    {
+        auto& registry = all_types();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        types = registry.types;
+    }
+
+    std::vector<extendable_stats_snapshot> snapshots;
+    for (const auto& type : types) {
+        snapshots.push_back(type.snapshot());
+    }
+
+    const auto write_counter = [&](
+        const char* name, const char* help, std::uint64_t extendable_stats_snapshot::*counter) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " counter\n";
+        for (std::size_t i = 0; i < types.size(); ++i) {
+            out << name << "{type=\"" << types[i].type_name << "\"} " << snapshots[i].*counter << "\n";
+        }
+    };
+    write_counter("extendable_lock_hits_total",
+        "weak_extender::lock() calls that produced a non-empty scoped_extender",
+        &extendable_stats_snapshot::lock_hits);
+    write_counter("extendable_lock_misses_total",
+        "weak_extender::lock() calls that produced an empty scoped_extender",
+        &extendable_stats_snapshot::lock_misses);
+    write_counter("extendable_lock_reset_races_total",
+        "lock() misses on a resource that was alive but marked for destruction",
+        &extendable_stats_snapshot::lock_reset_races);
+    write_counter("extendable_outlived_owner_total",
+        "scoped_extender-s released after their unique_extendable_ptr was reset",
+        &extendable_stats_snapshot::outlived_owner);
+}
+
+inline /*static*/ bool extendable_stats_exposition::dump(const char* path) {
+    std::ofstream file(path);
+    write(file);
+    return static_cast<bool>(file);
+}
+
+inline /*static*/ void extendable_stats_exposition::register_type(
+    const char* type_name, std::function<extendable_stats_snapshot()> snapshot) {
+    auto& registry = all_types();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.types.push_back(registered_type{type_name, std::move(snapshot)});
+}
+
+inline /*static*/ extendable_stats_exposition::registry& extendable_stats_exposition::all_types() {
+    static registry instance;
+    return instance;
+}
+
+#endif // _EXTENDABLE_STATS_IMPL_
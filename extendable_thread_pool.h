@@ -0,0 +1,270 @@
+#ifndef _EXTENDABLE_THREAD_POOL_
+#define _EXTENDABLE_THREAD_POOL_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "extendable_histogram.h"
+
+template <typename T> class weak_extender;
+
+/**
+ * @brief Throughput and latency of the tasks executed by a @see work_stealing_pool
+ */
+struct pool_statistics {
+    std::uint64_t completed_tasks = 0;
+    /**
+     * @brief Time between the submission of a task and the end of its execution
+     */
+    histogram_snapshot latency_ns;
+    /**
+     * @brief Time spent by workers executing tasks, summed over all workers
+     */
+    std::chrono::nanoseconds busy_time{0};
+    /**
+     * @brief Tasks submitted by work_stealing_pool::submit_extending() that
+     * were stolen from the worker they were routed to
+     */
+    std::uint64_t stolen_extending_tasks = 0;
+};
+
+/**
+ * @brief A fixed-size thread pool in which every worker has its own task
+ * queue and idle workers steal tasks from the queues of busy ones
+ * @details Tasks submitted from a worker go to the queue of that worker and
+ * are executed in LIFO order by it, other workers steal them in FIFO order.
+ * A task may also be pinned to a specific worker, in which case it is never
+ * stolen - this is intended for work that has to happen in a specific thread.
+ * A task that extends a resource may be submitted with submit_extending(), in
+ * which case it is routed to the worker that most recently extended the same
+ * resource.
+ *
+ * The destructor finishes all the submitted tasks before joining the workers.
+ */
+class work_stealing_pool {
+public:
+    explicit work_stealing_pool(
+        std::size_t thread_count = std::thread::hardware_concurrency());
+    ~work_stealing_pool();
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    std::size_t size() const;
+
+    /**
+     * @brief Schedules a task that may be executed by any worker
+     */
+    void submit(std::function<void()> task);
+    /**
+     * @brief Schedules a task that will be executed only by the given worker
+     */
+    void submit_pinned(std::size_t worker, std::function<void()> task);
+    /**
+     * @brief Schedules a task that calls the function with the resource of
+     * the weak_extender, unless the resource is gone by then
+     * @details The task is queued to the worker that most recently executed
+     * a task for the same resource, so that the reference counters of the
+     * resource stay in the cache of that worker instead of bouncing between
+     * cores. Other workers steal it only when they run out of work, the
+     * resource then follows the thief. A resource seen for the first time is
+     * queued the same way as by submit(). The routing is only a hint, tasks
+     * for the same resource may still run concurrently.
+     *
+     * @param function Is called as function(T&), must be copyable
+     */
+    template <typename T, typename Function>
+    void submit_extending(const weak_extender<T>&, Function function);
+
+    /**
+     * @brief Blocks until every task submitted so far has been executed
+     * @details Must not be called from a worker of the same pool
+     */
+    void wait_idle();
+
+    /**
+     * @brief Returns the index of the worker of this pool the calling thread
+     * is, or size() if the calling thread is not a worker of this pool
+     */
+    std::size_t current_worker() const;
+
+    pool_statistics statistics() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct task {
+        std::function<void()> work;
+        clock::time_point submitted;
+        /**
+         * @brief @see weak_extender::owner() of the resource the task
+         * extends, nullptr if it was not submitted by submit_extending()
+         */
+        const void* extends = nullptr;
+        std::size_t routed_to = 0;
+    };
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<task> stealable;
+        std::deque<task> pinned;
+        /**
+         * @brief Tasks routed by submit_extending(), other workers steal them
+         * only from the back of a backlog, the front is left for this worker
+         */
+        std::deque<task> affine;
+        std::atomic<std::size_t> pinned_count{0};
+        std::atomic<std::size_t> affine_count{0};
+        /**
+         * @brief The worker of the queue sleeps on it, so that a task for
+         * a specific worker wakes only that worker
+         */
+        std::condition_variable wake;
+        /**
+         * @brief Guarded by the sleep mutex, cleared by whoever wakes the worker
+         */
+        bool sleeping = false;
+    };
+
+    enum class queue_kind {
+        stealable,
+        pinned,
+        affine
+    };
+
+    /**
+     * @brief Worker that most recently executed a task for the owner
+     * @details The slots form a lossy hash table without any collision
+     * handling, since they are only a routing hint: a torn or overwritten
+     * slot merely sends a task to a worker that has to pull the reference
+     * counters into its cache.
+     */
+    struct affinity_slot {
+        std::atomic<const void*> owner{nullptr};
+        std::atomic<std::size_t> worker{0};
+    };
+    static constexpr std::size_t affinity_slot_count = 4096;
+
+    struct worker_identity {
+        const work_stealing_pool* pool;
+        std::size_t index;
+    };
+    static worker_identity& this_thread_identity();
+
+    void run_worker(std::size_t index);
+    /**
+     * @brief Whether the worker may find a task, must be called with the
+     * sleep mutex locked
+     */
+    bool has_work(const worker_queue&) const;
+    bool try_pop(std::size_t index, task&);
+    void execute(std::size_t index, task&);
+    void push(std::size_t index, task, queue_kind);
+    /**
+     * @brief The calling worker, or round robin if the calling thread is not
+     * a worker
+     */
+    std::size_t default_worker();
+    void submit_affine(const void* owner, std::function<void()> work);
+
+    affinity_slot& affinity_of(const void* owner) const;
+    /**
+     * @brief Must be called with the mutex of the queue locked, after the
+     * task was queued
+     * @details Wakes the worker of the queue if it sleeps. A task that other
+     * workers may steal wakes one of them otherwise, pinned tasks and affine
+     * tasks without a backlog wake nobody else.
+     */
+    void notify_submitted(worker_queue&, queue_kind);
+    /**
+     * @brief Must be called with the sleep mutex locked
+     */
+    worker_queue* any_sleeping_worker();
+
+    std::vector<std::unique_ptr<worker_queue>> queues;
+    std::vector<std::thread> workers;
+    std::unique_ptr<affinity_slot[]> affinity;
+
+    std::mutex sleep_mutex;
+    std::condition_variable idle;
+    bool stopping = false;
+    /**
+     * @brief Number of the queues with sleeping set, guarded by the sleep mutex
+     */
+    std::size_t sleeping_workers = 0;
+
+    std::atomic<std::size_t> stealable_count{0};
+    /**
+     * @brief Number of the affine tasks that may be stolen, i.e. all but
+     * the first one of every queue
+     */
+    std::atomic<std::size_t> affine_backlog{0};
+    std::atomic<std::size_t> in_flight{0};
+    std::atomic<std::size_t> next_queue{0};
+
+    std::atomic<std::uint64_t> completed{0};
+    std::atomic<std::uint64_t> busy_ns{0};
+    std::atomic<std::uint64_t> stolen_extending{0};
+    latency_histogram latency;
+};
+
+/**
+ * @brief A destruction policy that hands resources over to a
+ * @see work_stealing_pool instead of destroying them in place
+ * @details Intended to be used as a base of an
+ * @see extendable_destruction_policy specialization:
+ * @code
+ * template <>
+ * struct extendable_destruction_policy<gpu_buffer>
+ *     : pooled_destruction<gpu_buffer> {};
+ * @endcode
+ * Until a pool is attached (and after it is detached) resources are destroyed
+ * in place. The pool must be detached before it is destroyed, detach() waits
+ * for the destroy() calls that are submitting to it.
+ *
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+struct pooled_destruction {
+    /**
+     * @brief Destroys resources on any worker of the pool
+     */
+    static void attach(work_stealing_pool&);
+    /**
+     * @brief Destroys resources only on the given worker of the pool, for
+     * types which must be destroyed in a specific thread
+     */
+    static void attach(work_stealing_pool&, std::size_t worker);
+    /**
+     * @brief Returns once no destroy() call may submit to the pool anymore
+     */
+    static void detach();
+
+    static void destroy(std::unique_ptr<T>);
+
+private:
+    static constexpr std::size_t any_worker = static_cast<std::size_t>(-1);
+
+    struct target {
+        std::atomic<work_stealing_pool*> pool{nullptr};
+        std::atomic<std::size_t> worker{any_worker};
+        /**
+         * @brief destroy() calls that may use the pool they loaded
+         */
+        std::atomic<std::size_t> submitting{0};
+    };
+    static target& current_target();
+};
+
+#include "extendable_thread_pool_impl.h"
+
+#endif // _EXTENDABLE_THREAD_POOL_
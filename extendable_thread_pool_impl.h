@@ -0,0 +1,359 @@
+#ifndef _EXTENDABLE_THREAD_POOL_IMPL_
+#define _EXTENDABLE_THREAD_POOL_IMPL_
+
+inline work_stealing_pool::work_stealing_pool(std::size_t thread_count)
+    : affinity(new affinity_slot[affinity_slot_count]) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<worker_queue>());
+    }
+    for (std::size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back([this, i] { run_worker(i); });
+    }
+}
+
+inline work_stealing_pool::~work_stealing_pool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    for (auto& queue : queues) {
+        queue->wake.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+inline std::size_t work_stealing_pool::size() const {
+    return queues.size();
+}
+
+inline void work_stealing_pool::submit(std::function<void()> work) {
+    push(default_worker(), task{std::move(work), clock::now()}, queue_kind::stealable);
+}
+
+inline void work_stealing_pool::submit_pinned(std::size_t worker, std::function<void()> work) {
+    push(worker % size(), task{std::move(work), clock::now()}, queue_kind::pinned);
+}
+
+template <typename T, typename Function>
+void work_stealing_pool::submit_extending(const weak_extender<T>& extender, Function function) {
+    submit_affine(extender.owner(), [extender, function]() mutable {
+        const auto& scoped = extender.lock();
+        if (!scoped.empty()) {
+            function(*scoped.get());
+        }
+    });
+}
+
+inline void work_stealing_pool::wait_idle() {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    idle.wait(lock, [this] { return in_flight.load() == 0; });
+}
+
+inline std::size_t work_stealing_pool::current_worker() const {
+    const auto& identity = this_thread_identity();
+    return identity.pool == this ? identity.index : size();
+}
+
+inline pool_statistics work_stealing_pool::statistics() const {
+    pool_statistics result;
+    result.completed_tasks = completed.load(std::memory_order_relaxed);
+    result.latency_ns = latency.snapshot();
+    result.busy_time = std::chrono::nanoseconds(busy_ns.load(std::memory_order_relaxed));
+    result.stolen_extending_tasks = stolen_extending.load(std::memory_order_relaxed);
+    return result;
+}
+
+inline /*static*/ work_stealing_pool::worker_identity& work_stealing_pool::this_thread_identity() {
+    static thread_local worker_identity identity{nullptr, 0};
+    return identity;
+}
+
+inline void work_stealing_pool::run_worker(std::size_t index) {
+    this_thread_identity() = worker_identity{this, index};
+    auto& own = *queues[index];
+
+    for (;;) {
+        task next;
+        if (try_pop(index, next)) {
+            execute(index, next);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        if (!has_work(own)) {
+            own.sleeping = true;
+            ++sleeping_workers;
+            own.wake.wait(lock, [&] { return has_work(own); });
+            if (own.sleeping) {
+                own.sleeping = false;
+                --sleeping_workers;
+            }
+        }
+        if (stopping
+            && stealable_count.load() == 0
+            && own.pinned_count.load() == 0
+            && own.affine_count.load() == 0) {
+            return;
+        }
+    }
+}
+
+inline bool work_stealing_pool::has_work(const worker_queue& own) const {
+    return stopping
+        || stealable_count.load() != 0
+        || affine_backlog.load() != 0
+        || own.pinned_count.load() != 0
+        || own.affine_count.load() != 0;
+}
+
+inline bool work_stealing_pool::try_pop(std::size_t index, task& result) {
+    {
+        auto& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.pinned.empty()) {
+            result = std::move(own.pinned.front());
+            own.pinned.pop_front();
+            own.pinned_count.fetch_sub(1);
+            return true;
+        }
+        if (!own.affine.empty()) {
+            if (own.affine.size() > 1) {
+                affine_backlog.fetch_sub(1);
+            }
+            result = std::move(own.affine.front());
+            own.affine.pop_front();
+            own.affine_count.fetch_sub(1);
+            return true;
+        }
+        if (!own.stealable.empty()) {
+            result = std::move(own.stealable.back());
+            own.stealable.pop_back();
+            stealable_count.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < size(); ++offset) {
+        auto& victim = *queues[(index + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.stealable.empty()) {
+            result = std::move(victim.stealable.front());
+            victim.stealable.pop_front();
+            stealable_count.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // the affine tasks are stolen only as a last resort, from a worker that
+    // is behind
+    for (std::size_t offset = 1; offset < size(); ++offset) {
+        auto& victim = *queues[(index + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.affine.size() > 1) {
+            result = std::move(victim.affine.back());
+            victim.affine.pop_back();
+            victim.affine_count.fetch_sub(1);
+            affine_backlog.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void work_stealing_pool::execute(std::size_t index, task& current) {
+    if (current.extends != nullptr) {
+        // the task is about to pull the reference counters into the cache of this worker
+        auto& slot = affinity_of(current.extends);
+        slot.worker.store(index, std::memory_order_relaxed);
+        slot.owner.store(current.extends, std::memory_order_relaxed);
+        if (current.routed_to != index) {
+            stolen_extending.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const auto started = clock::now();
+    current.work();
+    current.work = nullptr;
+    const auto finished = clock::now();
+
+    latency.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(finished - current.submitted).count()));
+    busy_ns.fetch_add(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started).count()),
+        std::memory_order_relaxed);
+    completed.fetch_add(1, std::memory_order_relaxed);
+
+    if (in_flight.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        idle.notify_all();
+    }
+}
+
+inline void work_stealing_pool::push(std::size_t index, task queued, queue_kind kind) {
+    in_flight.fetch_add(1, std::memory_order_relaxed);
+    queued.routed_to = index;
+    auto& queue = *queues[index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        switch (kind) {
+        case queue_kind::stealable:
+            queue.stealable.push_back(std::move(queued));
+            break;
+        case queue_kind::pinned:
+            queue.pinned.push_back(std::move(queued));
+            break;
+        case queue_kind::affine:
+            queue.affine.push_back(std::move(queued));
+            break;
+        }
+        notify_submitted(queue, kind);
+    }
+}
+
+inline std::size_t work_stealing_pool::default_worker() {
+    auto index = current_worker();
+    if (index == size()) {
+        index = next_queue.fetch_add(1, std::memory_order_relaxed) % size();
+    }
+    return index;
+}
+
+inline void work_stealing_pool::submit_affine(const void* owner, std::function<void()> work) {
+    task queued{std::move(work), clock::now(), owner};
+    if (owner == nullptr) {
+        push(default_worker(), std::move(queued), queue_kind::stealable);
+        return;
+    }
+    auto& slot = affinity_of(owner);
+    if (slot.owner.load(std::memory_order_relaxed) != owner) {
+        // the following tasks go to the same worker even before this one runs
+        const auto index = default_worker();
+        slot.worker.store(index, std::memory_order_relaxed);
+        slot.owner.store(owner, std::memory_order_relaxed);
+        push(index, std::move(queued), queue_kind::affine);
+        return;
+    }
+    push(slot.worker.load(std::memory_order_relaxed) % size(), std::move(queued), queue_kind::affine);
+}
+
+inline work_stealing_pool::affinity_slot& work_stealing_pool::affinity_of(const void* owner) const {
+    // the low bits of the owners are the same, they live in control blocks
+    return affinity[(reinterpret_cast<std::uintptr_t>(owner) >> 4) % affinity_slot_count];
+}
+
+inline void work_stealing_pool::notify_submitted(worker_queue& queue, queue_kind kind) {
+    worker_queue* woken = nullptr;
+    {
+        // counters are updated under the sleep mutex so that a worker that is
+        // about to fall asleep can not miss them, and under the queue mutex
+        // so that they never lag behind the queue contents
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        switch (kind) {
+        case queue_kind::stealable:
+            stealable_count.fetch_add(1);
+            break;
+        case queue_kind::pinned:
+            queue.pinned_count.fetch_add(1);
+            break;
+        case queue_kind::affine:
+            queue.affine_count.fetch_add(1);
+            if (queue.affine.size() > 1) {
+                affine_backlog.fetch_add(1);
+            }
+            break;
+        }
+        const bool stealable = kind == queue_kind::stealable
+            || (kind == queue_kind::affine && queue.affine.size() > 1);
+        if (queue.sleeping) {
+            woken = &queue;
+        } else if (stealable) {
+            woken = any_sleeping_worker();
+        }
+        if (woken != nullptr) {
+            // claimed here, so that the next task wakes another worker
+            woken->sleeping = false;
+            --sleeping_workers;
+        }
+    }
+    if (woken != nullptr) {
+        woken->wake.notify_one();
+    }
+}
+
+inline work_stealing_pool::worker_queue* work_stealing_pool::any_sleeping_worker() {
+    if (sleeping_workers == 0) {
+        return nullptr;
+    }
+    for (auto& queue : queues) {
+        if (queue->sleeping) {
+            return queue.get();
+        }
+    }
+    return nullptr;
+}
+
+
+template <typename T>
+/*static*/ void pooled_destruction<T>::attach(work_stealing_pool& pool) {
+    attach(pool, any_worker);
+}
+
+template <typename T>
+/*static*/ void pooled_destruction<T>::attach(work_stealing_pool& pool, std::size_t worker) {
+    auto& target = current_target();
+    target.worker.store(worker);
+    target.pool.store(&pool);
+}
+
+template <typename T>
+/*static*/ void pooled_destruction<T>::detach() {
+    auto& target = current_target();
+    target.pool.store(nullptr);
+    // either a destroy() sees the pool gone or it is counted here
+    while (target.submitting.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+/*static*/ void pooled_destruction<T>::destroy(std::unique_ptr<T> resource) {
+    auto& target = current_target();
+    struct submission {
+        ~submission() {
+            submitting.fetch_sub(1);
+        }
+        std::atomic<std::size_t>& submitting;
+    };
+    target.submitting.fetch_add(1);
+    const submission counted{target.submitting};
+    auto* pool = target.pool.load();
+    if (pool == nullptr) {
+        resource.reset();
+        return;
+    }
+
+    // std::function requires a copyable callable, the resource stays owned
+    // until the task is queued and is destroyed in place if submitting throws
+    std::shared_ptr<T> owned(std::move(resource));
+    auto work = [owned]() mutable { owned.reset(); };
+    owned.reset();
+    const auto worker = target.worker.load();
+    if (worker == any_worker) {
+        pool->submit(std::move(work));
+    } else {
+        pool->submit_pinned(worker, std::move(work));
+    }
+}
+
+template <typename T>
+/*static*/ typename pooled_destruction<T>::target& pooled_destruction<T>::current_target() {
+    static target instance;
+    return instance;
+}
+
+#endif // _EXTENDABLE_THREAD_POOL_IMPL_
@@ -0,0 +1,113 @@
+#ifndef _EXTENDABLE_TRACER_
+#define _EXTENDABLE_TRACER_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Lifetime events recorded by @see extendable_tracer
+ */
+enum class trace_event_kind : std::uint8_t {
+    create,
+    lock,
+    lock_failed,
+    release,
+    reset,
+    destroy,
+};
+
+/**
+ * @brief Records lifetime events of resources into per-thread ring buffers
+ * and exports them in the Chrome trace event format, which can be opened in
+ * chrome://tracing or Perfetto. Enabled by EXTENDABLE_ENABLE_TRACING.
+ * @details Every resource is shown as an async span from its creation to its
+ * destruction with reset() and successful lock()-s as instant events on it,
+ * every scoped_extender is shown as a complete event on the thread that held
+ * it, failed lock()-s are thread-scoped instant events.
+ *
+ * To bound the overhead only 1 out of N resources is traced (all events of
+ * a traced resource are recorded), and every thread keeps only the last
+ * ring_capacity events. Recording is lock-free and touches only memory owned
+ * by the calling thread.
+ */
+class extendable_tracer {
+public:
+    static constexpr std::size_t ring_capacity = std::size_t(1) << 14;
+
+    /**
+     * @brief Tracing starts enabled, disabling it before dump() makes the
+     * dumped trace consistent
+     */
+    static void set_enabled(bool);
+    /**
+     * @brief Traces 1 out of every one_in resources, 1 traces everything
+     */
+    static void set_sampling(std::uint32_t one_in);
+
+    /**
+     * @brief Whether the events of the resource should be recorded. Events
+     * not attributed to a resource (nullptr) are sampled per thread instead.
+     */
+    static bool sampled(const void* resource);
+
+    /**
+     * @param start_ns Used only by trace_event_kind::release - the time of
+     * the corresponding lock()
+     */
+    static void record(
+        trace_event_kind,
+        const void* resource,
+        const char* type_name,
+        std::int64_t start_ns = 0);
+
+    /**
+     * @brief Writes the events currently held by all ring buffers as a
+     * Chrome trace JSON document
+     */
+    static void dump(std::ostream&);
+    /**
+     * @return false if the file could not be written
+     */
+    static bool dump(const char* path);
+
+private:
+    struct event {
+        std::atomic<std::int64_t> time_ns{0};
+        std::atomic<std::int64_t> start_ns{0};
+        std::atomic<const void*> resource{nullptr};
+        std::atomic<const char*> type_name{nullptr};
+        std::atomic<trace_event_kind> kind{trace_event_kind::create};
+    };
+
+    struct ring {
+        explicit ring(std::uint32_t thread_index);
+
+        const std::uint32_t thread_index;
+        /**
+         * @brief Number of events ever written into the ring
+         */
+        std::atomic<std::uint64_t> written{0};
+        std::array<event, ring_capacity> events;
+    };
+
+    struct state {
+        std::atomic<bool> enabled{true};
+        std::atomic<std::uint32_t> sampling{1};
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ring>> rings;
+    };
+
+    static state& global();
+    static ring& this_thread_ring();
+    static void write_event(std::ostream&, const event&, std::uint32_t thread_index);
+};
+
+#include "extendable_tracer_impl.h"
+
+#endif // _EXTENDABLE_TRACER_
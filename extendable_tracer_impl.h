@@ -0,0 +1,147 @@
+#ifndef _EXTENDABLE_TRACER_IMPL_
+#define _EXTENDABLE_TRACER_IMPL_
+
+#include <fstream>
+#include <iomanip>
+
+inline /*static*/ void extendable_tracer::set_enabled(bool enabled) {
+    global().enabled.store(enabled);
+}
+
+inline /*static*/ void extendable_tracer::set_sampling(std::uint32_t one_in) {
+    global().sampling.store(one_in != 0 ? one_in : 1, std::memory_order_relaxed);
+}
+
+inline /*static*/ bool extendable_tracer::sampled(const void* resource) {
+    const auto one_in = global().sampling.load(std::memory_order_relaxed);
+    if (one_in == 1) {
+        return true;
+    }
+    if (resource == nullptr) {
+        static thread_local std::uint32_t unattributed = 0;
+        return ++unattributed % one_in == 0;
+    }
+    // allocations are aligned, the low bits carry no information
+    const auto hash = (reinterpret_cast<std::uintptr_t>(resource) >> 4) * 0x9E3779B97F4A7C15ull;
+    return (hash >> 32) % one_in == 0;
+}
+
+inline /*static*/ void extendable_tracer::record(
+    trace_event_kind kind,
+    const void* resource,
+    const char* type_name,
+    std::int64_t start_ns) {
+    if (!global().enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    auto& ring = this_thread_ring();
+    const auto index = ring.written.load(std::memory_order_relaxed);
+    auto& slot = ring.events[index % ring_capacity];
+
+    slot.time_ns.store(instrumentation_clock_ns(), std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.resource.store(resource, std::memory_order_relaxed);
+    slot.type_name.store(type_name, std::memory_order_relaxed);
+    slot.kind.store(kind, std::memory_order_relaxed);
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+inline /*static*/ void extendable_tracer::dump(std::ostream& out) {
+    std::vector<std::shared_ptr<ring>> rings;
+    {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        rings = state.rings;
+    }
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    // timestamps are in microseconds with nanosecond resolution
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& ring : rings) {
+        const auto written = ring->written.load(std::memory_order_acquire);
+        const auto begin = written > ring_capacity ? written - ring_capacity : 0;
+
+        for (auto index = begin; index < written; ++index) {
+            const auto& slot = ring->events[index % ring_capacity];
+            if (!first) {
+                out << ",";
+            }
+            first = false;
+            write_event(out, slot, ring->thread_index);
+        }
+    }
+    out << "],\"displayTimeUnit\":\"ns\"}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+inline /*static*/ bool extendable_tracer::dump(const char* path) {
+    std::ofstream file(path);
+    dump(file);
+    return static_cast<bool>(file);
+}
+
+inline extendable_tracer::ring::ring(std::uint32_t thread_index)
+    : thread_index(thread_index) {}
+
+inline /*static*/ extendable_tracer::state& extendable_tracer::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ extendable_tracer::ring& extendable_tracer::this_thread_ring() {
+    static thread_local std::shared_ptr<ring> local = [] {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto created = std::make_shared<ring>(static_cast<std::uint32_t>(state.rings.size() + 1));
+        state.rings.push_back(created);
+        return created;
+    }();
+    return *local;
+}
+
+inline /*static*/ void extendable_tracer::write_event(
+    std::ostream& out, const event& slot, std::uint32_t thread_index) {
+    const auto kind = slot.kind.load(std::memory_order_relaxed);
+    const auto time_ns = slot.time_ns.load(std::memory_order_relaxed);
+    const auto start_ns = slot.start_ns.load(std::memory_order_relaxed);
+    const auto* type_name = slot.type_name.load(std::memory_order_relaxed);
+
+    const auto timestamp_us = [](std::int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+    out << "{\"pid\":1,\"tid\":" << thread_index << ",\"cat\":\"extendable\"";
+    out << ",\"id\":\"" << slot.resource.load(std::memory_order_relaxed) << "\"";
+    switch (kind) {
+    case trace_event_kind::create:
+        out << ",\"ph\":\"b\",\"name\":\"" << type_name << "\",\"ts\":" << timestamp_us(time_ns);
+        break;
+    case trace_event_kind::destroy:
+        out << ",\"ph\":\"e\",\"name\":\"" << type_name << "\",\"ts\":" << timestamp_us(time_ns);
+        break;
+    case trace_event_kind::reset:
+        out << ",\"ph\":\"n\",\"name\":\"" << type_name << "\",\"ts\":" << timestamp_us(time_ns)
+            << ",\"args\":{\"event\":\"reset\"}";
+        break;
+    case trace_event_kind::lock:
+        out << ",\"ph\":\"n\",\"name\":\"" << type_name << "\",\"ts\":" << timestamp_us(time_ns)
+            << ",\"args\":{\"event\":\"lock\"}";
+        break;
+    case trace_event_kind::lock_failed:
+        out << ",\"ph\":\"i\",\"s\":\"t\",\"name\":\"lock failed: " << type_name
+            << "\",\"ts\":" << timestamp_us(time_ns);
+        break;
+    case trace_event_kind::release:
+        out << ",\"ph\":\"X\",\"name\":\"extend " << type_name << "\",\"ts\":" << timestamp_us(start_ns)
+            << ",\"dur\":" << timestamp_us(time_ns - start_ns);
+        break;
+    }
+    out << "}";
+}
+
+#endif // _EXTENDABLE_TRACER_IMPL_
@@ -1,11 +1,675 @@
 #ifndef _EXTENDABLE_UNIQUE_OWNERSHIP_
 #define _EXTENDABLE_UNIQUE_OWNERSHIP_
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#include "extendable_instrumentation.h"
+#include "extendable_real_time.h"
+
+/**
+ * @brief Keeps a function shared by all the resource types out of line, so
+ * that it is not compiled again into the code of every resource type
+ */
+#if defined(_MSC_VER)
+#define EXTENDABLE_SHARED_CODE __declspec(noinline)
+#else
+#define EXTENDABLE_SHARED_CODE __attribute__((noinline))
+#endif
 
 template <typename T> class weak_extender;
 template <typename T> class scoped_extender;
+template <typename T> class pinned_extender;
+template <typename T> class extendable_group;
+template <typename T> class lease;
+template <typename T> class extendable_weak_set;
+template <typename Key, typename T> class extendable_index;
+struct extendable_core;
+
+/**
+ * @brief Result of a bulk @see reset_all() call
+ */
+struct bulk_reset_result {
+    /**
+     * @brief Number of unique_extendable_ptr-s that owned a resource and were reset
+     */
+    std::size_t reset = 0;
+    /**
+     * @brief Number of resources that were not destroyed by the call, because
+     * their lifetime was still extended (by a @see scoped_extender, a lease,
+     * an unfinished async construction or an open @see extension_scope) or
+     * because a @see real_time_thread handed their destruction over
+     * @details A resource counts as destroyed once it was handed to its
+     * @see extendable_destruction_policy, even if the policy destroys it
+     * elsewhere.
+     */
+    std::size_t deferred = 0;
+};
+
+/**
+ * @brief reset_all() internal steps, shared by the serial reset_all() and the
+ * one that releases the resources on a @see work_stealing_pool
+ */
+class bulk_reset {
+public:
+    /**
+     * @brief Marks every resource for destruction and reports the resets to
+     * the instrumentation, must be followed by a sequentially consistent
+     * fence and then by notify()
+     */
+    template <typename ForwardIt>
+    static void mark(ForwardIt first, ForwardIt last);
+    /**
+     * @brief Runs the reset subscriptions of the marked resources
+     */
+    template <typename ForwardIt>
+    static void notify(ForwardIt first, ForwardIt last);
+    /**
+     * @brief Releases the marked resources and counts the ones whose
+     * destruction was deferred
+     */
+    template <typename ForwardIt>
+    static bulk_reset_result release(ForwardIt first, ForwardIt last);
+
+    /**
+     * @brief Is called by every resource that is handed to its destruction
+     * policy, so that release() can tell whether the resource it released was
+     * destroyed in place
+     */
+    static void on_destroy(const void* resource);
+
+private:
+    struct destruction_watch {
+        const void* watched = nullptr;
+        bool destroyed = false;
+    };
+
+    static destruction_watch& this_thread_watch();
+};
+
+/**
+ * @brief Amortizes the cost of @see weak_extender::lock() across a job that
+ * accesses many resources
+ * @details A thread announces the current epoch when it opens its outermost
+ * scope and withdraws it when that scope closes. A destruction that races
+ * with an open scope is stamped with a new epoch and deferred until every
+ * scope opened before it has closed, the scopes opened afterwards do not
+ * hold it back. Because of that weak_extender::lock(const extension_scope&)
+ * only has to check that the resource was not marked for destruction and
+ * does not touch any reference counter, and opening a scope writes only to
+ * the cache line of its own thread.
+ *
+ * Same as @see scoped_extender it is uncopiable and unmovable, may be
+ * retrieved only by open() and may be caught only by const reference, so it
+ * can not outlive the job that opened it. It has to be closed by the thread
+ * that opened it, so it must not be held across a co_await that may resume
+ * elsewhere. A scope should still be closed as soon as possible, since every
+ * resource released in the meantime stays alive until then.
+ */
+class extension_scope {
+public:
+    static extension_scope open();
+
+    /**
+     * @brief Destroys the deferred resources that no scope open elsewhere
+     * may still read, if there are any
+     */
+    ~extension_scope();
+
+    extension_scope(const extension_scope&) = delete;
+    extension_scope& operator=(const extension_scope&) = delete;
+    extension_scope& operator=(extension_scope&&) = delete;
+
+private:
+    template <typename T> friend class unique_extendable_ptr;
+
+    /**
+     * @brief Epoch announced by a thread without an open scope
+     */
+    static constexpr std::uint64_t idle = UINT64_MAX;
+
+    /**
+     * @brief Epoch announced by a thread, never freed but taken over by a
+     * thread started after its own has exited
+     * @details Padded rather than aligned, so that it can be allocated by
+     * new also before C++17, and keeps the epoch off the cache lines of the
+     * neighbouring allocations
+     */
+    struct participant {
+        char leading_padding[64];
+        std::atomic<std::uint64_t> epoch{idle};
+        std::atomic_bool in_use{true};
+        participant* next = nullptr;
+        char trailing_padding[64];
+    };
+
+    struct thread_participation {
+        ~thread_participation();
+
+        participant* record;
+        std::size_t open_scopes;
+    };
+
+    struct deferred_destruction {
+        std::uint64_t epoch;
+        void* resource;
+        void (*destroy)(void*);
+    };
+
+    struct shared_state {
+        std::atomic<std::uint64_t> epoch{1};
+        std::atomic<participant*> participants{nullptr};
+        std::atomic<std::size_t> deferred_count{0};
+        std::mutex mutex;
+        std::vector<deferred_destruction> deferred;
+    };
+
+    extension_scope();
+    extension_scope(extension_scope&&);
+
+    static shared_state& state();
+    static thread_participation& this_thread_participation();
+    static participant* acquire_participant();
+    /**
+     * @brief Epoch announced by the oldest open scope, or bound if all of
+     * them are newer
+     */
+    static std::uint64_t oldest_open_epoch(std::uint64_t bound);
+    /**
+     * @brief Destroys the deferred resources that were retired before the
+     * oldest open scope was opened, has the signature of
+     * real_time_thread::deferred_work so that a real-time thread can hand it
+     * over
+     */
+    static void destroy_deferred(void*, std::size_t);
+    /**
+     * @brief Calls destroy(resource) right away if no scope is open,
+     * otherwise once the scopes open at the time have closed
+     */
+    static void destroy_or_defer(void* resource, void (*destroy)(void*));
+
+    bool open_scope;
+};
+
+/**
+ * @brief Resources currently extended by the @see scoped_extender-s of the
+ * calling thread
+ * @details Lets weak_extender::lock() borrow a resource that an outer
+ * scoped_extender of the same thread already extends instead of repeating the
+ * reference counting. A resource is extended by a single reference no matter
+ * how many extenders of the thread use it: if the scoped_extender that holds
+ * it is reset before the nested ones, the reference is parked in its entry
+ * until the last of them is reset.
+ *
+ * An extender remembers the registry it was registered in, since it may be
+ * reset on another thread, e.g. by a coroutine resumed elsewhere. Such a
+ * release is queued to the registering thread, which applies it the next
+ * time it locks or resets an extender, or when it exits. After the thread has
+ * exited the releases are applied right away.
+ *
+ * The registry of a thread is allocated by its first lock() with room for
+ * reserved_entries resources, extending more of them at once grows it.
+ */
+class currently_extended {
+private:
+    friend class weak_extender_base;
+    friend class scoped_extender_base;
+
+    /**
+     * @brief Resources a registry has room for before it grows
+     */
+    static constexpr std::size_t reserved_entries = 16;
+
+    /**
+     * @brief The reference of a released extender, together with the
+     * instrumentation of the release in case it is dropped later
+     */
+    struct released_reference : deferred_release_instrumentation {
+        released_reference() = default;
+        /**
+         * @brief Captures the release in progress in the calling thread
+         */
+        explicit released_reference(std::shared_ptr<void> reference);
+
+        /**
+         * @brief Drops the reference as a part of the release it comes from
+         */
+        void drop();
+
+        std::shared_ptr<void> reference;
+    };
+
+    struct entry {
+        const void* owner;
+        const void* resource;
+        std::size_t extenders;
+        released_reference parked;
+    };
+
+    struct remote_release {
+        const void* resource;
+        released_reference released;
+        remote_release* next;
+    };
+
+    /**
+     * @brief Entries of a thread, never freed but taken over by a thread
+     * started after its own has exited with no entries left
+     */
+    struct registry {
+        std::vector<entry> entries;
+        /**
+         * @brief Releases queued by the other threads, exited() once the
+         * thread has exited
+         */
+        std::atomic<remote_release*> remote{nullptr};
+        /**
+         * @brief Guards the entries once the thread has exited
+         */
+        std::mutex orphan_mutex;
+        registry* next = nullptr;
+    };
+
+    struct thread_registration {
+        ~thread_registration();
+
+        registry* record;
+    };
+
+    static registry& this_thread_registry();
+    static registry* acquire_registry();
+    static remote_release* exited();
+    static entry* find(registry&, const void* owner);
+
+    /**
+     * @brief Registers one more extender of the owner if the thread already
+     * extends it
+     * @return The registry of the extender, nullptr if the thread does not
+     * extend the owner
+     */
+    static registry* try_borrow(const void* owner);
+    /**
+     * @brief Registers the first extender of the owner, which holds the reference
+     * @return The registry of the extender
+     */
+    static registry* extend(const void* owner, const void* resource);
+    /**
+     * @brief Unregisters an extender of the resource, on whatever thread
+     * @param reference The reference held by the extender, empty for
+     * a borrowing one
+     * @return The reference that should be dropped by the caller, empty if it
+     * was parked for the remaining extenders or queued to the registering
+     * thread
+     */
+    static released_reference release(
+        registry*, const void* resource, std::shared_ptr<void> reference);
+    /**
+     * @brief The part of release() for the extenders registered by another
+     * thread, kept out of line
+     */
+    static released_reference release_elsewhere(
+        registry*, const void* resource, released_reference);
+    /**
+     * @brief Unregisters an extender from a registry owned by the caller
+     */
+    static released_reference release_in(
+        registry&, const void* resource, released_reference);
+    /**
+     * @brief Applies the releases queued by the other threads
+     */
+    static void drain(registry&);
+};
+
+/**
+ * @brief Continuations waiting for resources that are being constructed by
+ * @see make_unique_extendable_async()
+ * @details Kept aside from the resources, so that only the resources that are
+ * actually waited for pay for the continuations. The same goes for the
+ * exceptions of the failed constructions.
+ */
+class construction_continuations {
+private:
+    template <typename T> friend class unique_extendable_ptr;
+    friend class weak_extender_base;
+
+    using continuation = std::function<void(std::exception_ptr)>;
+
+    struct state {
+        std::mutex mutex;
+        std::unordered_multimap<const void*, continuation> waiting;
+        /**
+         * @brief Exceptions thrown by the constructors, kept until the owner
+         * is released
+         */
+        std::unordered_map<const void*, std::exception_ptr> errors;
+    };
+
+    static state& global();
+
+    /**
+     * @brief Calls the continuation right away if the owner is no longer
+     * constructing, otherwise when complete() is called for the owner
+     */
+    static void add(const extendable_core& owner, continuation);
+    /**
+     * @brief Records the exception and sets the failed status, is called
+     * before the constructing status is cleared
+     */
+    static void fail(const extendable_core& owner, std::exception_ptr);
+    /**
+     * @brief Calls the continuations of the owner, its constructing status
+     * should be already cleared
+     */
+    static void complete(const void* owner);
+    static std::exception_ptr error(const void* owner);
+    /**
+     * @brief Drops the exception of a released owner
+     */
+    static void forget(const void* owner);
+};
+
+/**
+ * @brief Callbacks that run when resources are marked for destruction, used
+ * by @see extendable_index to drop its entries as part of the reset
+ * @details Kept aside from the resources same as the construction
+ * continuations, so that only the subscribed resources pay for them. The
+ * subscriptions are spread over shards by owner, each with its own lock, so
+ * that the indexes and the resets of unrelated resources do not serialize on
+ * a single one. The callbacks run in the resetting thread outside of the
+ * lock of the shard, so a callback may still run after remove() returned.
+ */
+class reset_subscriptions {
+private:
+    friend struct extendable_core;
+    template <typename Key, typename T> friend class extendable_index;
+
+    struct subscription {
+        const void* subscriber;
+        std::function<void()> callback;
+    };
+
+    struct alignas(64) shard {
+        std::mutex mutex;
+        std::unordered_multimap<const void*, subscription> subscribed;
+    };
+    static constexpr std::size_t shard_count = 64;
+
+    static shard& shard_of(const void* owner);
+
+    /**
+     * @return false without subscribing if the resource was already marked
+     * for destruction
+     */
+    static bool add(const extendable_core&, const void* subscriber, std::function<void()>);
+    static void remove(const void* owner, const void* subscriber);
+    /**
+     * @brief Runs and drops the callbacks of the owner
+     */
+    static void notify(const void* owner);
+};
+
+/**
+ * @brief Part of the owner of a resource that does not depend on the type of
+ * the resource
+ * @details Every unique_extendable_ptr, @see weak_extender and
+ * @see scoped_extender links to it regardless of the resource type, so the
+ * reference counting, the marking and the locking are compiled once for all
+ * the resource types. Only the destruction of the resource and the reports to
+ * the instrumentation are left to the typed unique_extendable_ptr::resource_owner.
+ */
+struct extendable_core : resource_instrumentation {
+public:
+    using strong_lifetime_link = std::shared_ptr<extendable_core>;
+    using weak_lifetime_link = std::weak_ptr<extendable_core>;
+
+    explicit extendable_core(void* resource);
+
+    extendable_core(const extendable_core&) = delete;
+    extendable_core& operator=(const extendable_core&) = delete;
+    extendable_core(extendable_core&&) = delete;
+    extendable_core& operator=(extendable_core&&) = delete;
+
+    void* get() const;
+
+    static bool not_marked_for_destruction(const extendable_core*);
+    /**
+     * @brief Runs the @see reset_subscriptions of the resource, should be
+     * called after marked_for_destruction is set, sequentially consistent
+     */
+    void notify_reset() const;
+    /**
+     * @brief Adds a hold for a @see pinned_extender with a single increment,
+     * fails once the holds have dropped to zero or when max_pins pins are
+     * already alive
+     */
+    bool try_pin() const;
+    /**
+     * @brief Drops a hold, either of a pinned_extender or the one of the
+     * strong references
+     * @return Whether the caller dropped the last hold and has to release
+     * the resource
+     */
+    bool unpin() const;
+
+    /**
+     * @brief Bits of status
+     */
+    enum : std::uint8_t {
+        /**
+         * @brief Set while @see make_unique_extendable_async() is
+         * constructing the resource
+         */
+        constructing = 1,
+        /**
+         * @brief Set once the resource got a @see reset_subscriptions entry,
+         * so that only such resources look them up on reset
+         */
+        subscribed = 2,
+        /**
+         * @brief Set when the constructor called by
+         * @see make_unique_extendable_async() has thrown
+         */
+        failed = 4
+    };
+    /**
+     * @brief Set in holds once they have dropped to zero, never cleared
+     */
+    static constexpr std::uint16_t dying = 0x8000;
+    /**
+     * @brief Number of simultaneously alive @see pinned_extender-s of
+     * a resource
+     * @details Is checked before the increment, so the holds never reach
+     * dying by overflow unless more than dying - max_pins threads pin the
+     * same resource at the very same time.
+     */
+    static constexpr std::uint16_t max_pins = 0x4000;
+
+    /**
+     * @brief Owned, is left in place by unique_extendable_ptr::resource_owner::release()
+     * since it may still be read by the locks inside an @see extension_scope. Is nullptr until the
+     * construction started by @see make_unique_extendable_async() completes.
+     */
+    std::atomic<void*> resource;
+    /**
+     * @brief Number of @see lease-s, which are counted apart from the
+     * scoped_extender-s since they may outlive the owner until the deadline
+     */
+    std::atomic<std::uint32_t> leases;
+    /**
+     * @brief Used to stop providing access to the resource immidiately
+     * after the unique_extendable_ptr was destroyed (in case the access is
+     * requested through a @see weak_extender that is still alive)
+     */
+    std::atomic_bool marked_for_destruction;
+    mutable std::atomic<std::uint8_t> status;
+    /**
+     * @brief One hold for all the strong references plus one per
+     * @see pinned_extender, the resource is released by whoever drops the
+     * last of them
+     */
+    mutable std::atomic<std::uint16_t> holds;
+};
+
+/**
+ * @brief Part of @see scoped_extender that does not depend on the type of
+ * the resource
+ */
+class scoped_extender_base : protected extender_instrumentation {
+public:
+    bool empty() const;
+
+protected:
+    friend class weak_extender_base;
+
+    using strong_lifetime_link = extendable_core::strong_lifetime_link;
+
+    scoped_extender_base() = default;
+    /**
+     * @brief Constructs an extender that borrows the resource from an open
+     * @see extension_scope
+     */
+    explicit scoped_extender_base(void* borrowed);
+    scoped_extender_base(scoped_extender_base&&);
+
+    /**
+     * @brief Drops the reference or the borrowed resource
+     */
+    void release();
+    /**
+     * @brief The part of release() for the extenders registered in
+     * @see currently_extended, is static so that the extenders borrowed from
+     * an @see extension_scope can be kept in registers
+     */
+    static void release_registered(currently_extended::registry*, const void* resource, strong_lifetime_link);
+
+    /**
+     * @brief Empty when the resource is borrowed
+     */
+    strong_lifetime_link link;
+    void* resource = nullptr;
+    /**
+     * @brief Registry of @see currently_extended the extender was registered
+     * in, nullptr when the resource is borrowed from an @see extension_scope
+     */
+    currently_extended::registry* registered = nullptr;
+};
+
+/**
+ * @brief Part of @see weak_extender that does not depend on the type of the
+ * resource
+ */
+class weak_extender_base {
+public:
+    /**
+     * @brief Whether the resource is still being constructed by
+     * @see make_unique_extendable_async()
+     */
+    bool pending() const;
+    /**
+     * @brief Whether the constructor called by
+     * @see make_unique_extendable_async() has thrown, lock() never succeeds
+     * for such a resource
+     */
+    bool failed() const;
+    /**
+     * @brief The exception thrown by the constructor of a failed() resource,
+     * nullptr otherwise or once the owner has been reset
+     */
+    std::exception_ptr construction_error() const;
+    /**
+     * @brief Calls the continuation once the resource is no longer pending(),
+     * either in the thread that constructed it or right away in the calling
+     * thread
+     */
+    void when_ready(std::function<void()>) const;
+    /**
+     * @brief Same as when_ready(std::function<void()>), the continuation
+     * receives the exception of a failed construction or nullptr
+     */
+    void when_ready(std::function<void(std::exception_ptr)>) const;
+    /**
+     * @brief Stops assotiating itself with the corresponding @see unique_extendable_ptr
+     */
+    void reset();
+    /**
+     * @brief Identifies the resource, is the same for all the weak_extender-s
+     * of a resource and stays unique for as long as any of them exists,
+     * nullptr for an empty one
+     */
+    const void* owner() const;
+
+protected:
+    using strong_lifetime_link = extendable_core::strong_lifetime_link;
+    using weak_lifetime_link = extendable_core::weak_lifetime_link;
+
+    enum class lock_result {
+        /**
+         * @brief An outer scoped_extender of the thread already extends the resource
+         */
+        borrowed,
+        locked,
+        pending,
+        /**
+         * @brief The asynchronous construction has thrown
+         */
+        failed,
+        marked_for_destruction,
+        expired
+    };
+
+    weak_extender_base() = default;
+    explicit weak_extender_base(const strong_lifetime_link&);
+
+    /**
+     * @brief The part of weak_extender::lock() that does not depend on the
+     * type of the resource
+     * @param extender Is empty, receives the resource unless the lock fails
+     */
+    lock_result lock_into(scoped_extender_base& extender) const;
+    /**
+     * @brief Whether the resource may be accessed inside an open @see extension_scope
+     */
+    bool accessible_in_scope() const;
+
+    weak_lifetime_link link;
+    /**
+     * @brief Lets lock(const extension_scope&) reach marked_for_destruction
+     * without locking the link
+     */
+    const extendable_core* target = nullptr;
+};
+
+/**
+ * @brief Customization point that decides how and where a resource is
+ * destroyed once its lifetime is no longer extended by anything
+ * @details The default policy destroys the resource in place, i.e. in the
+ * thread that released the last unique_extendable_ptr or @see scoped_extender.
+ * Specialize it for types with expensive destructors or types that must be
+ * destroyed in a specific thread, e.g. to hand the resource over to
+ * a @see pooled_destruction.
+ *
+ * @tparam T Type of the owned resource
+ */
+template <typename T>
+struct extendable_destruction_policy {
+    static void destroy(std::unique_ptr<T>);
+};
 
 /**
  * @brief Smart pointer which in terms of lifetime management concepts is
@@ -32,6 +696,8 @@ template <typename T> class scoped_extender;
 template <typename T>
 class unique_extendable_ptr {
 public:
+    using element_type = T;
+
     /**
      * @brief Counstructs and empty smart pointer that does not own anything
      */
@@ -51,10 +717,24 @@ public:
     unique_extendable_ptr(const unique_extendable_ptr&) = delete;
     unique_extendable_ptr& operator=(const unique_extendable_ptr&) = delete;
     unique_extendable_ptr(unique_extendable_ptr&&) = default;
-    unique_extendable_ptr& operator=(unique_extendable_ptr&&) = default;
+    /**
+     * @brief Resets the currently owned resource before taking over the
+     * resource of the other unique_extendable_ptr
+     */
+    unique_extendable_ptr& operator=(unique_extendable_ptr&&);
 
     T* get() const;
     T* operator->() const;
+    /**
+     * @brief Whether it owns a resource, get() must not be called otherwise
+     */
+    explicit operator bool() const;
+
+    /**
+     * @brief Number of @see lease-s that currently extend the resource, each
+     * of them until its deadline at the latest
+     */
+    std::size_t leases() const;
 
     /**
      * @brief Stops owning the resource and destroys it if its lifetime was not
@@ -68,39 +748,125 @@ public:
 private:
     friend class weak_extender<T>;
     friend class scoped_extender<T>;
+    friend class pinned_extender<T>;
+    friend class extendable_group<T>;
+
+    friend class bulk_reset;
+    template <typename U, typename Executor, typename... CtorArgTypes>
+    friend unique_extendable_ptr<U> make_unique_extendable_async(Executor&, CtorArgTypes&&...);
 
     struct resource_owner;
+    template <typename... CtorArgTypes> struct async_construction;
+    template <typename U> struct control_block_allocator;
 
-    using strong_lifetime_link = std::shared_ptr<resource_owner>;
-    using weak_lifetime_link = std::weak_ptr<resource_owner>;
+    using strong_lifetime_link = extendable_core::strong_lifetime_link;
+    using weak_lifetime_link = extendable_core::weak_lifetime_link;
 
     strong_lifetime_link resource;
 };
 
 /**
- * @brief unique_extendable_ptr internal struct
+ * @brief unique_extendable_ptr internal struct, the typed part of the owner
+ * that knows how to destroy the resource
  */
 template <typename T>
-struct unique_extendable_ptr<T>::resource_owner {
+struct unique_extendable_ptr<T>::resource_owner : extendable_core {
 public:
-    resource_owner();
     explicit resource_owner(std::unique_ptr<T>);
 
-    resource_owner(const resource_owner&) = delete;
-    resource_owner& operator=(const resource_owner&) = delete;
-    resource_owner(resource_owner&&) = delete;
-    resource_owner& operator=(resource_owner&&) = delete;
+    /**
+     * @brief Drops the hold of the strong references and releases the
+     * resource unless a @see pinned_extender still holds it
+     * @details Is called by control_block_allocator instead of the destructor
+     * once the last strong reference is gone. The resource_owner itself is
+     * never destroyed, its storage is reclaimed together with the control
+     * block, so marked_for_destruction stays readable as long as any
+     * @see weak_extender refers to it.
+     */
+    void release();
+    /**
+     * @brief Hands the resource over to @see extendable_destruction_policy,
+     * possibly deferred by @see extension_scope, once the last hold is dropped
+     */
+    void release_unheld();
+    /**
+     * @brief The part of release() that a @see real_time_thread hands over
+     */
+    static void hand_over(void* resource, std::size_t);
+    static void destroy(void* resource);
+};
 
-    T* get() const;
-    T* operator->() const;
+/**
+ * @brief unique_extendable_ptr internal task that constructs the resource
+ * for @see make_unique_extendable_async()
+ */
+template <typename T>
+template <typename... CtorArgTypes>
+struct unique_extendable_ptr<T>::async_construction {
+public:
+    template <typename... ArgTypes>
+    async_construction(strong_lifetime_link, ArgTypes&&...);
 
-    std::unique_ptr<T> resource;
     /**
-     * @brief Used to stop providing access to the resource immidiately
-     * after the unique_extendable_ptr was destroyed (in case the access is
-     * requested through a @see weak_extender that is still alive)
+     * @brief Constructs the resource unless the owner was reset in the
+     * meantime, publishes it and calls the continuations
+     * @details A constructor that throws leaves the resource empty and
+     * marks it as failed, its exception is passed to the continuations
      */
-    std::atomic_bool marked_for_destruction;
+    void operator()();
+
+private:
+    template <std::size_t... Indices>
+    T* construct(std::index_sequence<Indices...>);
+
+    strong_lifetime_link owner;
+    std::tuple<CtorArgTypes...> arguments;
+};
+
+/**
+ * @brief unique_extendable_ptr internal allocator of the control blocks that
+ * hold resource_owner-s, reports the allocations to the instrumentation
+ */
+template <typename T>
+template <typename U>
+struct unique_extendable_ptr<T>::control_block_allocator {
+public:
+    using value_type = U;
+
+    template <typename V>
+    struct rebind {
+        using other = control_block_allocator<V>;
+    };
+
+    control_block_allocator() = default;
+    template <typename V>
+    control_block_allocator(const control_block_allocator<V>&);
+
+    U* allocate(std::size_t);
+    void deallocate(U*, std::size_t);
+
+    /**
+     * @brief Is handed over by a @see real_time_thread
+     */
+    static void deallocate_in_place(void*, std::size_t);
+
+    template <typename V>
+    void destroy(V*);
+    /**
+     * @brief @see resource_owner::release()
+     */
+    void destroy(resource_owner*);
+
+    template <typename V>
+    bool operator==(const control_block_allocator<V>&) const;
+    template <typename V>
+    bool operator!=(const control_block_allocator<V>&) const;
+
+private:
+    /**
+     * @brief Control blocks accounted for a single allocation of U
+     */
+    static constexpr std::size_t blocks();
 };
 
 /**
@@ -110,6 +876,51 @@ public:
 template <typename T, typename... CtorArgTypes>
 unique_extendable_ptr<T> make_unique_extendable(CtorArgTypes&&... ctorArgs);
 
+/**
+ * @brief Returns the owner of a resource that is constructed by a task
+ * submitted to the executor
+ * @details The owner and the @see weak_extender-s to it may be used right
+ * away: until the construction completes unique_extendable_ptr::get() returns
+ * nullptr, weak_extender::lock() returns an empty scoped_extender and
+ * weak_extender::pending() returns true. Consumers may wait for the
+ * construction with weak_extender::when_ready() or co_await
+ * weak_extender::ready(). If the owner is reset before the task starts the
+ * resource is not constructed at all. If the constructor throws the resource
+ * stays empty, weak_extender::failed() returns true and the exception is
+ * passed to the continuations and rethrown by co_await.
+ *
+ * @param executor Any object with submit(std::function<void()>), e.g.
+ * a @see work_stealing_pool
+ * @param ctorArgs Are stored by value until the task runs
+ */
+template <typename T, typename Executor, typename... CtorArgTypes>
+unique_extendable_ptr<T> make_unique_extendable_async(Executor& executor, CtorArgTypes&&... ctorArgs);
+
+/**
+ * @brief Resets every unique_extendable_ptr in [first, last) as a single batch
+ * @details Has the same effect as calling unique_extendable_ptr::reset() on
+ * every element, but is intended for mass teardown (level unload, shutdown).
+ * All resources are marked for destruction in one pass followed by a single
+ * fence instead of a sequentially consistent store per element, so none of
+ * them is accessible through @see weak_extender by the time the first one is
+ * destroyed. Only then are the resources released.
+ *
+ * Resources that are still extended by a @see scoped_extender are destroyed
+ * when the last scoped_extender leaves the scope, the same way as with
+ * unique_extendable_ptr::reset(). Their number is reported in the result.
+ * The release may also be spread over a pool, see reset_all(work_stealing_pool&, Range&).
+ *
+ * @tparam ForwardIt Iterator over unique_extendable_ptr-s, must be multi-pass
+ */
+template <typename ForwardIt>
+bulk_reset_result reset_all(ForwardIt first, ForwardIt last);
+
+/**
+ * @brief @see reset_all(ForwardIt, ForwardIt) for a whole storage
+ */
+template <typename Range>
+bulk_reset_result reset_all(Range& range);
+
 /**
  * @brief An object that does not extend the lifetime of a resource owned by
  * the corresponding @see unique_extendable_ptr but provides the means to
@@ -118,7 +929,7 @@ unique_extendable_ptr<T> make_unique_extendable(CtorArgTypes&&... ctorArgs);
  * the resource owned by @see unique_extendable_ptr
  */
 template <typename T>
-class weak_extender {
+class weak_extender : private weak_extender_base {
 public:
     weak_extender() = default;
     explicit weak_extender(const unique_extendable_ptr<T>&);
@@ -131,22 +942,121 @@ public:
     /**
      * @brief Returns an object that provides access to the resource
      * owned by @see unique_extendable_ptr
+     * @details If a scoped_extender of the calling thread already extends
+     * the resource, the returned one borrows it without any atomic read-modify-
+     * write and is not reported to the instrumentation
+     * @param call_site Captured automatically and only when the enabled
+     * instrumentation needs it, should not be passed explicitly
      */
-    scoped_extender<T> lock() const;
+    scoped_extender<T> lock(
+        const extendable_call_site& call_site = extendable_call_site::current()) const;
     /**
-     * @brief Stops assotiating itself with the corresponding @see unique_extendable_ptr
+     * @brief Returns an object that provides access to the resource for as
+     * long as the scope is open
+     * @details Only checks whether the resource was marked for destruction,
+     * does not change any reference counter and is not reported to the
+     * instrumentation. The returned scoped_extender does not extend the
+     * lifetime of the resource by itself.
      */
-    void reset();
+    scoped_extender<T> lock(const extension_scope&) const;
+    /**
+     * @brief Returns an object that provides access to the resource from
+     * a real-time thread, wait-free
+     * @details Pins the resource with a single atomic increment and copies
+     * the weak reference, never allocates, frees or blocks, and is not
+     * reported to the instrumentation. Fails instead of retrying when it
+     * races with the release of the resource, and when the resource already
+     * has extendable_core::max_pins pinned_extender-s.
+     */
+    pinned_extender<T> lock(const real_time_thread&) const;
+
+    using weak_extender_base::pending;
+    using weak_extender_base::failed;
+    using weak_extender_base::construction_error;
+    using weak_extender_base::when_ready;
+
+    /**
+     * @brief Returns a storable @see lease that extends the resource until
+     * the deadline, an expired one if the resource is not accessible
+     */
+    lease<T> lease_until(std::chrono::steady_clock::time_point deadline) const;
+    /**
+     * @brief Returns a storable @see lease that extends the resource for the
+     * given number of lease_reaper::advance_frame() calls
+     */
+    lease<T> lease_for_frames(std::uint64_t frames) const;
+#if defined(__cpp_impl_coroutine)
+    class readiness;
+    /**
+     * @brief Returns an awaitable that resumes the coroutine once the
+     * resource is no longer pending(), rethrows the exception of a failed()
+     * construction
+     */
+    readiness ready() const;
+#endif
+    using weak_extender_base::reset;
+    using weak_extender_base::owner;
 
 private:
     friend class scoped_extender<T>;
+    friend class extendable_group<T>;
+    friend class extendable_weak_set<T>;
+    template <typename Key, typename U> friend class extendable_index;
 
-    using resource = typename unique_extendable_ptr<T>::resource_owner;
-    using weak_lifetime_link = typename unique_extendable_ptr<T>::weak_lifetime_link;
+    explicit weak_extender(const strong_lifetime_link&);
 
-    static bool not_marked_for_destruction(const resource*);
+    T* target_resource() const;
 
-    weak_lifetime_link link;
+    lease<T> make_lease(std::chrono::steady_clock::time_point deadline, std::uint64_t deadline_frame) const;
+};
+
+#if defined(__cpp_impl_coroutine)
+/**
+ * @brief Awaitable returned by weak_extender::ready()
+ */
+template <typename T>
+class weak_extender<T>::readiness {
+public:
+    explicit readiness(weak_extender);
+
+    bool await_ready() const;
+    void await_suspend(std::coroutine_handle<>) const;
+    void await_resume() const;
+
+private:
+    weak_extender extender;
+};
+#endif
+
+/**
+ * @brief Hashes a @see weak_extender by the resource it refers to, see
+ * weak_extender::owner()
+ * @details Never touches the resource or its reference counters, so
+ * weak_extender-s may be used as keys of unordered containers without locking
+ * them. Different resources never share an owner while any weak_extender
+ * refers to them. All the empty weak_extender-s are equal.
+ */
+struct owner_hash {
+    template <typename T>
+    std::size_t operator()(const weak_extender<T>&) const;
+};
+
+/**
+ * @brief Compares @see weak_extender-s by the resources they refer to, for
+ * unordered containers together with @see owner_hash
+ */
+struct owner_equal {
+    template <typename T>
+    bool operator()(const weak_extender<T>&, const weak_extender<T>&) const;
+};
+
+/**
+ * @brief Strict weak ordering of @see weak_extender-s by the resources they
+ * refer to, for ordered containers, same as std::owner_less for std::weak_ptr
+ */
+struct owner_before {
+    template <typename T>
+    bool operator()(const weak_extender<T>&, const weak_extender<T>&) const;
 };
 
 /**
@@ -158,8 +1068,13 @@ private:
  * time.
  */
 template <typename T>
-class scoped_extender {
+class scoped_extender : private scoped_extender_base {
 public:
+    /**
+     * @brief @see reset()
+     */
+    ~scoped_extender();
+
     scoped_extender(const scoped_extender&) = delete;
     scoped_extender& operator=(const scoped_extender&) = delete;
     scoped_extender& operator=(scoped_extender&&) = delete;
@@ -167,7 +1082,7 @@ public:
     T* get() const;
     T* operator->() const;
 
-    bool empty() const;
+    using scoped_extender_base::empty;
     /**
      * @brief Stops assotiating itself with the corresponding @see unique_extendable_ptr
      */
@@ -176,16 +1091,58 @@ public:
 private:
     friend class weak_extender<T>;
 
-    using strong_lifetime_link = typename unique_extendable_ptr<T>::strong_lifetime_link;
-
     scoped_extender() = default;
-    explicit scoped_extender(strong_lifetime_link);
+    /**
+     * @brief @see scoped_extender_base::scoped_extender_base(void*)
+     */
+    explicit scoped_extender(T*);
 
     scoped_extender(scoped_extender&&) = default;
+};
 
-    strong_lifetime_link link;
+/**
+ * @brief An object that provides access to the resource for a
+ * @see real_time_thread, returned by weak_extender::lock(const real_time_thread&)
+ * @details Holds the resource by a pin instead of a strong reference: taking
+ * it is a single atomic increment and the copy of a weak reference, releasing
+ * it a single decrement. Whoever drops the last hold, be it the strong
+ * references or a pin, releases the resource, and a real-time thread hands
+ * that work over to real_time_thread::reclaim().
+ *
+ * Same as @see scoped_extender it is uncopiable and unmovable and may be
+ * caught only by const reference. Is not registered as extending the resource
+ * for the nested locks of the thread.
+ */
+template <typename T>
+class pinned_extender {
+public:
+    ~pinned_extender();
+
+    pinned_extender(const pinned_extender&) = delete;
+    pinned_extender& operator=(const pinned_extender&) = delete;
+    pinned_extender& operator=(pinned_extender&&) = delete;
+
+    T* get() const;
+    T* operator->() const;
+
+    bool empty() const;
+    /**
+     * @brief Drops the pin
+     */
+    void reset();
+
+private:
+    friend class weak_extender<T>;
+
+    pinned_extender() = default;
+    pinned_extender(pinned_extender&&);
+
+    extendable_core::weak_lifetime_link link;
+    const extendable_core* core = nullptr;
+    T* resource = nullptr;
 };
 
 #include "extendable_unique_ownership_impl.h"
+#include "extendable_lease.h"
 
 #endif // _EXTENDABLE_UNIQUE_OWNERSHIP_
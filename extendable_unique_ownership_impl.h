@@ -1,43 +1,725 @@
 #ifndef _SHAREABLE_UNIQUE_OWNERSHIP_IMPL_
 #define _SHAREABLE_UNIQUE_OWNERSHIP_IMPL_
 
+inline /*static*/ extension_scope extension_scope::open() {
+    return extension_scope();
+}
+
+inline extension_scope::extension_scope()
+    : open_scope(true) {
+    auto& participation = this_thread_participation();
+    if (participation.open_scopes++ != 0) {
+        return;
+    }
+    // a destruction retired at this epoch or later waits for the scope
+    participation.record->epoch.store(state().epoch.load());
+    // pairs with the fence in destroy_or_defer(): either every lock inside
+    // the scope sees the released reference or the release sees the scope
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+inline extension_scope::extension_scope(extension_scope&& other)
+    : open_scope(other.open_scope) {
+    other.open_scope = false;
+}
+
+inline extension_scope::~extension_scope() {
+    if (!open_scope) {
+        return;
+    }
+    auto& participation = this_thread_participation();
+    if (--participation.open_scopes != 0) {
+        return;
+    }
+    participation.record->epoch.store(idle);
+    // pairs with the increment in destroy_or_defer(): either the closing
+    // scope sees the deferred destruction or the deferring thread sees the
+    // scope closed
+    if (state().deferred_count.load() == 0) {
+        return;
+    }
+    if (!real_time_thread::try_hand_off(&destroy_deferred, nullptr, 0)) {
+        destroy_deferred(nullptr, 0);
+    }
+}
+
+inline /*static*/ extension_scope::shared_state& extension_scope::state() {
+    static shared_state shared;
+    return shared;
+}
+
+inline extension_scope::thread_participation::~thread_participation() {
+    record->in_use.store(false, std::memory_order_release);
+}
+
+inline /*static*/ extension_scope::thread_participation& extension_scope::this_thread_participation() {
+    static thread_local thread_participation participation{acquire_participant(), 0};
+    return participation;
+}
+
+inline /*static*/ extension_scope::participant* extension_scope::acquire_participant() {
+    auto& shared = state();
+    for (auto record = shared.participants.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        auto in_use = false;
+        if (!record->in_use.load(std::memory_order_relaxed) &&
+            record->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+            return record;
+        }
+    }
+    // the records are never freed, so a thread may walk them without a lock
+    auto record = new participant();
+    auto head = shared.participants.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!shared.participants.compare_exchange_weak(head, record, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+    return record;
+}
+
+inline /*static*/ std::uint64_t extension_scope::oldest_open_epoch(std::uint64_t bound) {
+    auto oldest = bound;
+    for (auto record = state().participants.load(std::memory_order_acquire); record != nullptr;
+         record = record->next) {
+        oldest = std::min(oldest, record->epoch.load());
+    }
+    return oldest;
+}
+
+inline /*static*/ void extension_scope::destroy_deferred(void*, std::size_t) {
+    auto& shared = state();
+    std::vector<deferred_destruction> ready;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        // a scope opened from now on announces at least the current epoch,
+        // so it does not hold back anything retired so far
+        const auto oldest = oldest_open_epoch(shared.epoch.load());
+        const auto first_ready = std::partition(shared.deferred.begin(), shared.deferred.end(),
+            [oldest](const deferred_destruction& destruction) { return destruction.epoch >= oldest; });
+        ready.assign(first_ready, shared.deferred.end());
+        shared.deferred.erase(first_ready, shared.deferred.end());
+        shared.deferred_count.store(shared.deferred.size());
+    }
+    for (const auto& destruction : ready) {
+        destruction.destroy(destruction.resource);
+    }
+}
+
+inline /*static*/ void extension_scope::destroy_or_defer(void* resource, void (*destroy)(void*)) {
+    auto& shared = state();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (oldest_open_epoch(idle) == idle) {
+        destroy(resource);
+        return;
+    }
+    // the scopes opened after the increment see the resource marked and the
+    // ones opened before announced an epoch not newer than retired
+    const auto retired = shared.epoch.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.deferred.push_back(deferred_destruction{retired, resource, destroy});
+        shared.deferred_count.fetch_add(1);
+    }
+    destroy_deferred(nullptr, 0);
+}
+
+inline currently_extended::released_reference::released_reference(std::shared_ptr<void> reference)
+    : deferred_release_instrumentation(capture())
+    , reference(std::move(reference)) {}
+
+inline void currently_extended::released_reference::drop() {
+    const resumed release(*this);
+    reference.reset();
+}
+
+inline currently_extended::thread_registration::~thread_registration() {
+    std::vector<released_reference> dropped;
+    {
+        std::lock_guard<std::mutex> lock(record->orphan_mutex);
+        // from now on the other threads apply their releases themselves
+        auto pending = record->remote.exchange(exited(), std::memory_order_acq_rel);
+        while (pending != nullptr) {
+            dropped.push_back(release_in(*record, pending->resource, std::move(pending->released)));
+            delete std::exchange(pending, pending->next);
+        }
+    }
+    for (auto& reference : dropped) {
+        reference.drop();
+    }
+}
+
+inline /*static*/ currently_extended::registry& currently_extended::this_thread_registry() {
+    // reached without the initialization guard of thread_registration
+    static thread_local registry* current = nullptr;
+    if (current == nullptr) {
+        static thread_local thread_registration registration{acquire_registry()};
+        current = registration.record;
+    }
+    if (current->remote.load(std::memory_order_relaxed) != nullptr) {
+        drain(*current);
+    }
+    return *current;
+}
+
+inline /*static*/ currently_extended::registry* currently_extended::acquire_registry() {
+    static std::atomic<registry*> registries{nullptr};
+    for (auto record = registries.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+        if (record->remote.load(std::memory_order_relaxed) != exited()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(record->orphan_mutex, std::try_to_lock);
+        // an extender still registered there may be reset by another thread
+        if (lock.owns_lock() && record->remote.load(std::memory_order_relaxed) == exited() &&
+            record->entries.empty()) {
+            record->remote.store(nullptr, std::memory_order_relaxed);
+            return record;
+        }
+    }
+    // the records are never freed, so a thread may walk them without a lock
+    auto record = new registry();
+    record->entries.reserve(reserved_entries);
+    auto head = registries.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!registries.compare_exchange_weak(head, record, std::memory_order_release,
+                                               std::memory_order_relaxed));
+    return record;
+}
+
+inline /*static*/ currently_extended::remote_release* currently_extended::exited() {
+    static remote_release marker{nullptr, {}, nullptr};
+    return &marker;
+}
+
+inline /*static*/ currently_extended::entry* currently_extended::find(registry& record, const void* owner) {
+    // the most recently extended resources are the most likely to be locked again
+    for (auto it = record.entries.rbegin(); it != record.entries.rend(); ++it) {
+        if (it->owner == owner) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+inline /*static*/ currently_extended::registry* currently_extended::try_borrow(const void* owner) {
+    auto& record = this_thread_registry();
+    auto* found = find(record, owner);
+    if (found == nullptr) {
+        return nullptr;
+    }
+    ++found->extenders;
+    return &record;
+}
+
+inline /*static*/ currently_extended::registry* currently_extended::extend(
+    const void* owner, const void* resource) {
+    auto& record = this_thread_registry();
+    record.entries.push_back(entry{owner, resource, 1, {}});
+    return &record;
+}
+
+inline /*static*/ currently_extended::released_reference currently_extended::release(
+    registry* record, const void* resource, std::shared_ptr<void> reference) {
+    if (record == &this_thread_registry()) {
+        return release_in(*record, resource, released_reference(std::move(reference)));
+    }
+    return release_elsewhere(record, resource, released_reference(std::move(reference)));
+}
+
+EXTENDABLE_SHARED_CODE inline /*static*/ currently_extended::released_reference currently_extended::release_elsewhere(
+    registry* record, const void* resource, released_reference released) {
+    auto head = record->remote.load(std::memory_order_acquire);
+    if (head != exited()) {
+        auto queued = new remote_release{resource, std::move(released), head};
+        while (!record->remote.compare_exchange_weak(head, queued, std::memory_order_release,
+                                                     std::memory_order_acquire)) {
+            if (head == exited()) {
+                released = std::move(queued->released);
+                delete queued;
+                break;
+            }
+            queued->next = head;
+        }
+        if (head != exited()) {
+            return released_reference();
+        }
+    }
+    // the registering thread has exited, nobody else applies the release
+    std::lock_guard<std::mutex> lock(record->orphan_mutex);
+    return release_in(*record, resource, std::move(released));
+}
+
+inline /*static*/ currently_extended::released_reference currently_extended::release_in(
+    registry& record, const void* resource, released_reference released) {
+    auto found = record.entries.rbegin();
+    while (found != record.entries.rend() && found->resource != resource) {
+        ++found;
+    }
+    // every registered extender has an entry until the last of them is
+    // released, without one there is nothing else to release
+    if (found == record.entries.rend()) {
+        return released;
+    }
+    if (--found->extenders != 0) {
+        if (released.reference != nullptr) {
+            found->parked = std::move(released);
+        }
+        return released_reference();
+    }
+    if (released.reference == nullptr) {
+        released = std::move(found->parked);
+    }
+    *found = std::move(record.entries.back());
+    record.entries.pop_back();
+    return released;
+}
+
+EXTENDABLE_SHARED_CODE inline /*static*/ void currently_extended::drain(registry& record) {
+    auto pending = record.remote.exchange(nullptr, std::memory_order_acquire);
+    while (pending != nullptr) {
+        // may destroy the resource, which may lock or reset other extenders
+        release_in(record, pending->resource, std::move(pending->released)).drop();
+        delete std::exchange(pending, pending->next);
+    }
+}
+
+inline /*static*/ construction_continuations::state& construction_continuations::global() {
+    static state instance;
+    return instance;
+}
+
+inline /*static*/ void construction_continuations::add(
+    const extendable_core& owner, continuation waiting) {
+    std::exception_ptr error;
+    {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        // complete() clears the flag before it takes the lock
+        if ((owner.status.load(std::memory_order_acquire) & extendable_core::constructing) != 0) {
+            state.waiting.emplace(&owner, std::move(waiting));
+            return;
+        }
+        auto found = state.errors.find(&owner);
+        if (found != state.errors.end()) {
+            error = found->second;
+        }
+    }
+    waiting(std::move(error));
+}
+
+inline /*static*/ void construction_continuations::fail(
+    const extendable_core& owner, std::exception_ptr error) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.errors[&owner] = std::move(error);
+    owner.status.fetch_or(extendable_core::failed, std::memory_order_release);
+}
+
+inline /*static*/ void construction_continuations::complete(const void* owner) {
+    std::vector<continuation> ready;
+    std::exception_ptr error;
+    {
+        auto& state = global();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto range = state.waiting.equal_range(owner);
+        for (auto it = range.first; it != range.second; ++it) {
+            ready.push_back(std::move(it->second));
+        }
+        state.waiting.erase(range.first, range.second);
+        auto found = state.errors.find(owner);
+        if (found != state.errors.end()) {
+            error = found->second;
+        }
+    }
+    for (auto& continuation : ready) {
+        continuation(error);
+    }
+}
+
+inline /*static*/ std::exception_ptr construction_continuations::error(const void* owner) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto found = state.errors.find(owner);
+    return found != state.errors.end() ? found->second : nullptr;
+}
+
+inline /*static*/ void construction_continuations::forget(const void* owner) {
+    auto& state = global();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.errors.erase(owner);
+}
+
+
+inline /*static*/ reset_subscriptions::shard& reset_subscriptions::shard_of(const void* owner) {
+    static shard shards[shard_count];
+    // the low bits of the owners are the same, they live in control blocks
+    return shards[(reinterpret_cast<std::uintptr_t>(owner) >> 4) % shard_count];
+}
+
+inline /*static*/ bool reset_subscriptions::add(
+    const extendable_core& owner, const void* subscriber, std::function<void()> callback) {
+    owner.status.fetch_or(extendable_core::subscribed);
+    auto& state = shard_of(&owner);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    // either the reset sees the flag and waits for the lock, or this sees the mark
+    if (owner.marked_for_destruction.load()) {
+        return false;
+    }
+    state.subscribed.emplace(&owner, subscription{subscriber, std::move(callback)});
+    return true;
+}
+
+inline /*static*/ void reset_subscriptions::remove(const void* owner, const void* subscriber) {
+    auto& state = shard_of(owner);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto range = state.subscribed.equal_range(owner);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.subscriber == subscriber) {
+            state.subscribed.erase(it);
+            return;
+        }
+    }
+}
+
+inline /*static*/ void reset_subscriptions::notify(const void* owner) {
+    std::vector<std::function<void()>> callbacks;
+    {
+        auto& state = shard_of(owner);
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto range = state.subscribed.equal_range(owner);
+        for (auto it = range.first; it != range.second; ++it) {
+            callbacks.push_back(std::move(it->second.callback));
+        }
+        state.subscribed.erase(range.first, range.second);
+    }
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+
+inline extendable_core::extendable_core(void* resource)
+    : resource(resource)
+    , leases(0)
+    , marked_for_destruction(false)
+    , status(0)
+    , holds(1) {}
+
+inline void* extendable_core::get() const {
+    return resource.load(std::memory_order_acquire);
+}
+
+inline /*static*/ bool extendable_core::not_marked_for_destruction(const extendable_core* core) {
+    return core != nullptr && !core->marked_for_destruction.load();
+}
+
+inline void extendable_core::notify_reset() const {
+    if ((status.load() & subscribed) != 0) {
+        reset_subscriptions::notify(this);
+    }
+}
+
+inline bool extendable_core::try_pin() const {
+    if (holds.load(std::memory_order_relaxed) > max_pins) {
+        return false;
+    }
+    // a failed pin is undone without a release, the last hold is long gone
+    if ((holds.fetch_add(1, std::memory_order_acq_rel) & dying) != 0) {
+        holds.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+inline bool extendable_core::unpin() const {
+    // without any pin the last hold is taken in a single step
+    std::uint16_t last = 1;
+    if (holds.load(std::memory_order_relaxed) == last &&
+        holds.compare_exchange_strong(last, dying, std::memory_order_acq_rel)) {
+        return true;
+    }
+    if (holds.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return false;
+    }
+    // a pin that raced to revive the holds releases them again later
+    std::uint16_t expected = 0;
+    return holds.compare_exchange_strong(expected, dying, std::memory_order_acq_rel);
+}
+
+
+inline weak_extender_base::weak_extender_base(const strong_lifetime_link& owner)
+    : link(owner)
+    , target(owner.get()) {}
+
+EXTENDABLE_SHARED_CODE inline weak_extender_base::lock_result weak_extender_base::lock_into(
+    scoped_extender_base& extender) const {
+    if (extendable_core::not_marked_for_destruction(target)) {
+        if (auto* registered = currently_extended::try_borrow(target)) {
+            extender.resource = target->get();
+            extender.registered = registered;
+            return lock_result::borrowed;
+        }
+    }
+    auto locked = link.lock();
+    if (locked == nullptr) {
+        return lock_result::expired;
+    }
+    if (!extendable_core::not_marked_for_destruction(locked.get())) {
+        return lock_result::marked_for_destruction;
+    }
+    if (locked->get() == nullptr) {
+        return (locked->status.load(std::memory_order_acquire) & extendable_core::failed) != 0
+            ? lock_result::failed
+            : lock_result::pending;
+    }
+    extender.resource = locked->get();
+    extender.registered = currently_extended::extend(target, extender.resource);
+    extender.link = std::move(locked);
+    return lock_result::locked;
+}
+
+inline bool weak_extender_base::accessible_in_scope() const {
+    // the scope keeps the resource alive once the link is seen unexpired
+    return !link.expired() && extendable_core::not_marked_for_destruction(target);
+}
+
+inline bool weak_extender_base::pending() const {
+    return target != nullptr && (target->status.load(std::memory_order_acquire) & extendable_core::constructing) != 0;
+}
+
+inline bool weak_extender_base::failed() const {
+    return target != nullptr && (target->status.load(std::memory_order_acquire) & extendable_core::failed) != 0;
+}
+
+inline std::exception_ptr weak_extender_base::construction_error() const {
+    return failed() ? construction_continuations::error(target) : nullptr;
+}
+
+inline void weak_extender_base::when_ready(std::function<void()> continuation) const {
+    when_ready([continuation](std::exception_ptr) { continuation(); });
+}
+
+inline void weak_extender_base::when_ready(std::function<void(std::exception_ptr)> continuation) const {
+    if (target == nullptr) {
+        continuation(nullptr);
+        return;
+    }
+    construction_continuations::add(*target, std::move(continuation));
+}
+
+inline void weak_extender_base::reset() {
+    link.reset();
+    target = nullptr;
+}
+
+inline const void* weak_extender_base::owner() const {
+    return target;
+}
+
+
+inline scoped_extender_base::scoped_extender_base(void* borrowed)
+    : resource(borrowed) {}
+
+inline scoped_extender_base::scoped_extender_base(scoped_extender_base&& other)
+    : extender_instrumentation(std::move(other))
+    , link(std::move(other.link))
+    , resource(other.resource)
+    , registered(other.registered) {
+    other.resource = nullptr;
+    other.registered = nullptr;
+}
+
+inline bool scoped_extender_base::empty() const {
+    return resource == nullptr;
+}
+
+inline void scoped_extender_base::release() {
+    // the ones borrowed from an extension_scope are not registered
+    if (registered != nullptr) {
+        release_registered(registered, resource, std::move(link));
+    }
+    resource = nullptr;
+    registered = nullptr;
+}
+
+EXTENDABLE_SHARED_CODE inline /*static*/ void scoped_extender_base::release_registered(
+    currently_extended::registry* registered, const void* resource, strong_lifetime_link reference) {
+    currently_extended::release(registered, resource, std::move(reference)).drop();
+}
+
+
 template <typename T>
-unique_extendable_ptr<T>::resource_owner::resource_owner()
-    : marked_for_destruction(false) {}
+/*static*/ void extendable_destruction_policy<T>::destroy(std::unique_ptr<T> resource) {
+    resource.reset();
+}
+
 
 template <typename T>
-unique_extendable_ptr<T>::resource_owner::resource_owner(
-    std::unique_ptr<T> resource)
-    : marked_for_destruction(false)
-    , resource(std::move(resource)) {}
+unique_extendable_ptr<T>::resource_owner::resource_owner(std::unique_ptr<T> resource)
+    : extendable_core(resource.release()) {}
 
 template <typename T>
-T* unique_extendable_ptr<T>::resource_owner::get() const {
-    return resource.get();
+void unique_extendable_ptr<T>::resource_owner::release() {
+    // the last pinned_extender releases it otherwise
+    if (unpin()) {
+        release_unheld();
+    }
 }
 
 template <typename T>
-T* unique_extendable_ptr<T>::resource_owner::operator->() const {
-    return get();
+void unique_extendable_ptr<T>::resource_owner::release_unheld() {
+    if ((status.load(std::memory_order_relaxed) & failed) != 0) {
+        construction_continuations::forget(this);
+    }
+    extendable_instrumentation<T>::on_destroy(*this);
+    auto* released = get();
+    if (released != nullptr && !real_time_thread::try_hand_off(&hand_over, released, 0)) {
+        hand_over(released, 0);
+    }
+}
+
+template <typename T>
+/*static*/ void unique_extendable_ptr<T>::resource_owner::hand_over(void* resource, std::size_t) {
+    extension_scope::destroy_or_defer(resource, &destroy);
+}
+
+template <typename T>
+/*static*/ void unique_extendable_ptr<T>::resource_owner::destroy(void* resource) {
+    bulk_reset::on_destroy(resource);
+    extendable_destruction_policy<T>::destroy(std::unique_ptr<T>(static_cast<T*>(resource)));
+}
+
+
+template <typename T>
+template <typename... CtorArgTypes>
+template <typename... ArgTypes>
+unique_extendable_ptr<T>::async_construction<CtorArgTypes...>::async_construction(
+    strong_lifetime_link owner, ArgTypes&&... arguments)
+    : owner(std::move(owner))
+    , arguments(std::forward<ArgTypes>(arguments)...) {}
+
+template <typename T>
+template <typename... CtorArgTypes>
+void unique_extendable_ptr<T>::async_construction<CtorArgTypes...>::operator()() {
+    T* constructed = nullptr;
+    if (!owner->marked_for_destruction.load()) {
+        try {
+            constructed = construct(std::index_sequence_for<CtorArgTypes...>());
+        } catch (...) {
+            construction_continuations::fail(*owner, std::current_exception());
+        }
+    }
+    owner->resource.store(constructed, std::memory_order_release);
+    owner->status.fetch_and(static_cast<std::uint8_t>(~extendable_core::constructing), std::memory_order_release);
+    construction_continuations::complete(owner.get());
+    // destroys the resource right away if the owner was reset in the meantime
+    owner.reset();
+}
+
+template <typename T>
+template <typename... CtorArgTypes>
+template <std::size_t... Indices>
+T* unique_extendable_ptr<T>::async_construction<CtorArgTypes...>::construct(
+    std::index_sequence<Indices...>) {
+    return new T(std::move(std::get<Indices>(arguments))...);
+}
+
+
+template <typename T>
+template <typename U>
+template <typename V>
+unique_extendable_ptr<T>::control_block_allocator<U>::control_block_allocator(
+    const control_block_allocator<V>&) {}
+
+template <typename T>
+template <typename U>
+U* unique_extendable_ptr<T>::control_block_allocator<U>::allocate(std::size_t count) {
+    auto* memory = std::allocator<U>().allocate(count);
+    extendable_instrumentation<T>::on_control_block_allocated(blocks(), count * sizeof(U));
+    return memory;
+}
+
+template <typename T>
+template <typename U>
+void unique_extendable_ptr<T>::control_block_allocator<U>::deallocate(U* memory, std::size_t count) {
+    extendable_instrumentation<T>::on_control_block_deallocated(blocks(), count * sizeof(U));
+    if (!real_time_thread::try_hand_off(&deallocate_in_place, memory, count)) {
+        deallocate_in_place(memory, count);
+    }
+}
+
+template <typename T>
+template <typename U>
+/*static*/ void unique_extendable_ptr<T>::control_block_allocator<U>::deallocate_in_place(
+    void* memory, std::size_t count) {
+    std::allocator<U>().deallocate(static_cast<U*>(memory), count);
+}
+
+template <typename T>
+template <typename U>
+/*static*/ constexpr std::size_t unique_extendable_ptr<T>::control_block_allocator<U>::blocks() {
+    // the resource owners of an extendable_group belong to the group's control block
+    return std::is_same<U, resource_owner>::value ? 0 : 1;
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+void unique_extendable_ptr<T>::control_block_allocator<U>::destroy(V* object) {
+    object->~V();
+}
+
+template <typename T>
+template <typename U>
+void unique_extendable_ptr<T>::control_block_allocator<U>::destroy(resource_owner* owner) {
+    extendable_instrumentation<T>::on_control_block_released();
+    owner->release();
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+bool unique_extendable_ptr<T>::control_block_allocator<U>::operator==(
+    const control_block_allocator<V>&) const {
+    return true;
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+bool unique_extendable_ptr<T>::control_block_allocator<U>::operator!=(
+    const control_block_allocator<V>&) const {
+    return false;
 }
 
 
 template <typename T>
 unique_extendable_ptr<T>::unique_extendable_ptr(std::unique_ptr<T> resource)
     : resource(
-        std::make_shared<resource_owner>(
+        std::allocate_shared<resource_owner>(
+            control_block_allocator<resource_owner>(),
             std::move(resource)
         )
-    ) {}
+    ) {
+    extendable_instrumentation<T>::on_create(*this->resource);
+}
 
 template <typename T>
 unique_extendable_ptr<T>::~unique_extendable_ptr() {
     reset();
 }
 
+template <typename T>
+unique_extendable_ptr<T>& unique_extendable_ptr<T>::operator=(unique_extendable_ptr&& other) {
+    if (this != &other) {
+        reset();
+        resource = std::move(other.resource);
+    }
+    return *this;
+}
+
 template <typename T>
 T* unique_extendable_ptr<T>::get() const {
-    return resource->get();
+    return static_cast<T*>(resource->get());
 }
 
 template <typename T>
@@ -45,10 +727,17 @@ T* unique_extendable_ptr<T>::operator->() const {
     return get();
 }
 
+template <typename T>
+unique_extendable_ptr<T>::operator bool() const {
+    return resource != nullptr;
+}
+
 template <typename T>
 void unique_extendable_ptr<T>::reset() {
     if (resource != nullptr) {
         resource->marked_for_destruction.store(true);
+        resource->notify_reset();
+        extendable_instrumentation<T>::on_reset(*resource);
         resource.reset();
     }
 }
@@ -59,37 +748,213 @@ unique_extendable_ptr<T> make_unique_extendable(CtorArgTypes&&... ctorArgs) {
     return unique_extendable_ptr<T>(std::move(unique));
 }
 
+template <typename T, typename Executor, typename... CtorArgTypes>
+unique_extendable_ptr<T> make_unique_extendable_async(Executor& executor, CtorArgTypes&&... ctorArgs) {
+    using construction = typename unique_extendable_ptr<T>::template async_construction<
+        typename std::decay<CtorArgTypes>::type...>;
+
+    unique_extendable_ptr<T> owner{std::unique_ptr<T>()};
+    owner.resource->status.fetch_or(extendable_core::constructing, std::memory_order_relaxed);
+    // std::function requires a copyable task while the arguments may be move-only
+    auto task = std::make_shared<construction>(owner.resource, std::forward<CtorArgTypes>(ctorArgs)...);
+    executor.submit([task] { (*task)(); });
+    return owner;
+}
+
+template <typename ForwardIt>
+/*static*/ void bulk_reset::mark(ForwardIt first, ForwardIt last) {
+    using resource_type = typename std::iterator_traits<ForwardIt>::value_type::element_type;
+    for (auto it = first; it != last; ++it) {
+        if (it->resource != nullptr) {
+            it->resource->marked_for_destruction.store(true, std::memory_order_relaxed);
+            extendable_instrumentation<resource_type>::on_reset(*it->resource);
+        }
+    }
+}
+
+template <typename ForwardIt>
+/*static*/ void bulk_reset::notify(ForwardIt first, ForwardIt last) {
+    for (auto it = first; it != last; ++it) {
+        if (it->resource != nullptr) {
+            it->resource->notify_reset();
+        }
+    }
+}
+
+template <typename ForwardIt>
+/*static*/ bulk_reset_result bulk_reset::release(ForwardIt first, ForwardIt last) {
+    bulk_reset_result result;
+    auto& watch = this_thread_watch();
+    for (auto it = first; it != last; ++it) {
+        if (it->resource == nullptr) {
+            continue;
+        }
+        ++result.reset;
+        // an async construction that is still running publishes the resource later
+        const bool constructing =
+            (it->resource->status.load(std::memory_order_acquire) & extendable_core::constructing) != 0;
+        watch.watched = it->resource->get();
+        watch.destroyed = false;
+        it->resource.reset();
+        if (constructing || (watch.watched != nullptr && !watch.destroyed)) {
+            ++result.deferred;
+        }
+    }
+    watch.watched = nullptr;
+    return result;
+}
+
+inline /*static*/ void bulk_reset::on_destroy(const void* resource) {
+    auto& watch = this_thread_watch();
+    if (resource == watch.watched) {
+        watch.destroyed = true;
+    }
+}
+
+inline /*static*/ bulk_reset::destruction_watch& bulk_reset::this_thread_watch() {
+    static thread_local destruction_watch watch;
+    return watch;
+}
+
+template <typename ForwardIt>
+bulk_reset_result reset_all(ForwardIt first, ForwardIt last) {
+    bulk_reset::mark(first, last);
+    // publishes all the marks before any of the resources is released
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bulk_reset::notify(first, last);
+    return bulk_reset::release(first, last);
+}
+
+template <typename Range>
+bulk_reset_result reset_all(Range& range) {
+    using std::begin;
+    using std::end;
+    return reset_all(begin(range), end(range));
+}
+
 
 template <typename T>
 weak_extender<T>::weak_extender(const unique_extendable_ptr<T>& owner)
-    : link(owner.resource) {}
+    : weak_extender(owner.resource) {}
+
+template <typename T>
+weak_extender<T>::weak_extender(const strong_lifetime_link& owner)
+    : weak_extender_base(owner) {}
 
 template <typename T>
-scoped_extender<T> weak_extender<T>::lock() const {
-    auto strong_link = link.lock();
-    return not_marked_for_destruction(strong_link.get())
-        ? scoped_extender<T>(strong_link)
-        : scoped_extender<T>();
+scoped_extender<T> weak_extender<T>::lock(const extendable_call_site& call_site) const {
+    scoped_extender<T> extender;
+    switch (lock_into(extender)) {
+    case lock_result::locked:
+        extendable_instrumentation<T>::on_lock(extender, *target, call_site);
+        break;
+    case lock_result::borrowed:
+        extendable_instrumentation<T>::on_lock_borrowed();
+        break;
+    case lock_result::pending:
+    case lock_result::failed:
+        extendable_instrumentation<T>::on_lock_failed(target, false);
+        break;
+    case lock_result::marked_for_destruction:
+        extendable_instrumentation<T>::on_lock_failed(target, true);
+        break;
+    case lock_result::expired:
+        extendable_instrumentation<T>::on_lock_failed(nullptr, false);
+        break;
+    }
+    return extender;
 }
 
 template <typename T>
-void weak_extender<T>::reset() {
-    link.reset();
+scoped_extender<T> weak_extender<T>::lock(const extension_scope&) const {
+    if (!accessible_in_scope()) {
+        // the resource is alive only if it was marked for destruction
+        const bool alive = !link.expired();
+        extendable_instrumentation<T>::on_lock_failed(alive ? target : nullptr, alive);
+        return scoped_extender<T>();
+    }
+    extendable_instrumentation<T>::on_lock_borrowed();
+    return scoped_extender<T>(target_resource());
+}
+
+template <typename T>
+pinned_extender<T> weak_extender<T>::lock(const real_time_thread&) const {
+    pinned_extender<T> extender;
+    if (target == nullptr || !target->try_pin()) {
+        return extender;
+    }
+    extender.link = link;
+    extender.core = target;
+    extender.resource = target_resource();
+    if (!extendable_core::not_marked_for_destruction(target) || extender.resource == nullptr) {
+        extender.reset();
+    }
+    return extender;
+}
+
+#if defined(__cpp_impl_coroutine)
+template <typename T>
+typename weak_extender<T>::readiness weak_extender<T>::ready() const {
+    return readiness(*this);
+}
+
+template <typename T>
+weak_extender<T>::readiness::readiness(weak_extender extender)
+    : extender(std::move(extender)) {}
+
+template <typename T>
+bool weak_extender<T>::readiness::await_ready() const {
+    return !extender.pending();
+}
+
+template <typename T>
+void weak_extender<T>::readiness::await_suspend(std::coroutine_handle<> coroutine) const {
+    extender.when_ready([coroutine] { coroutine.resume(); });
+}
+
+template <typename T>
+void weak_extender<T>::readiness::await_resume() const {
+    if (auto error = extender.construction_error()) {
+        std::rethrow_exception(error);
+    }
+}
+#endif
+
+template <typename T>
+T* weak_extender<T>::target_resource() const {
+    return static_cast<T*>(target->get());
+}
+
+
+template <typename T>
+std::size_t owner_hash::operator()(const weak_extender<T>& extender) const {
+    // the low bits of the owners are the same, they live in control blocks
+    return static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(extender.owner()) >> 4);
 }
 
 template <typename T>
-/*static*/ bool weak_extender<T>::not_marked_for_destruction(const resource* resource) {
-    return resource != nullptr && !resource->marked_for_destruction.load();
+bool owner_equal::operator()(const weak_extender<T>& lhs, const weak_extender<T>& rhs) const {
+    return lhs.owner() == rhs.owner();
+}
+
+template <typename T>
+bool owner_before::operator()(const weak_extender<T>& lhs, const weak_extender<T>& rhs) const {
+    return std::less<const void*>()(lhs.owner(), rhs.owner());
 }
 
 
 template <typename T>
-scoped_extender<T>::scoped_extender(strong_lifetime_link link)
-    : link(std::move(link)) {}
+scoped_extender<T>::scoped_extender(T* borrowed)
+    : scoped_extender_base(borrowed) {}
+
+template <typename T>
+scoped_extender<T>::~scoped_extender() {
+    reset();
+}
 
 template <typename T>
 T* scoped_extender<T>::get() const {
-    return !empty() ? link->get() : nullptr;
+    return static_cast<T*>(resource);
 }
 
 template <typename T>
@@ -98,12 +963,59 @@ T* scoped_extender<T>::operator->() const {
 }
 
 template <typename T>
-bool scoped_extender<T>::empty() const {
-    return link == nullptr;
+void scoped_extender<T>::reset() {
+    const bool extends = link != nullptr;
+    if (extends) {
+        extendable_instrumentation<T>::on_release(*this, *link, link->marked_for_destruction);
+    }
+    release();
+    if (extends) {
+        extendable_instrumentation<T>::after_release(*this);
+    }
 }
 
+
 template <typename T>
-void scoped_extender<T>::reset() {
+pinned_extender<T>::pinned_extender(pinned_extender&& other)
+    : link(std::move(other.link))
+    , core(other.core)
+    , resource(other.resource) {
+    other.core = nullptr;
+    other.resource = nullptr;
+}
+
+template <typename T>
+pinned_extender<T>::~pinned_extender() {
+    reset();
+}
+
+template <typename T>
+T* pinned_extender<T>::get() const {
+    return resource;
+}
+
+template <typename T>
+T* pinned_extender<T>::operator->() const {
+    return get();
+}
+
+template <typename T>
+bool pinned_extender<T>::empty() const {
+    return resource == nullptr;
+}
+
+template <typename T>
+void pinned_extender<T>::reset() {
+    if (core == nullptr) {
+        return;
+    }
+    if (core->unpin()) {
+        using resource_owner = typename unique_extendable_ptr<T>::resource_owner;
+        static_cast<resource_owner*>(const_cast<extendable_core*>(core))->release_unheld();
+    }
+    core = nullptr;
+    resource = nullptr;
+    // frees the control block in reclaim() if it was the last reference
     link.reset();
 }
 
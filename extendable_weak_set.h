@@ -0,0 +1,128 @@
+#ifndef _EXTENDABLE_WEAK_SET_
+#define _EXTENDABLE_WEAK_SET_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "extendable_unique_ownership.h"
+
+/**
+ * @brief Set of @see weak_extender-s that may be queried and iterated
+ * concurrently with inserts and erases, e.g. subscribers or targets in range
+ * @details An open-addressing table with linear probing, keyed by
+ * weak_extender::owner() through @see owner_hash. Lookups only compare the
+ * owners and never lock, iteration only counts its readers in the visited
+ * slots. Inserts and erases are serialized by a mutex that lookups and
+ * iteration never wait for.
+ *
+ * Entries whose resources were reset or marked for destruction are pruned
+ * whenever an insert, erase or iteration probes past them, so the set does
+ * not keep growing with stale entries. The freed slots are reused by the
+ * following inserts, and a run of them that ends at an empty slot becomes
+ * empty again right away, so lookups that miss do not walk over the erased
+ * entries of a set that keeps being filled and emptied.
+ *
+ * The number of slots is fixed at construction, an insert fails once no slot
+ * is free. Probing stays short while at most about a half of them is used.
+ *
+ * @tparam T Type of the resources
+ */
+template <typename T>
+class extendable_weak_set {
+public:
+    /**
+     * @param slot_count Rounded up to a power of two
+     */
+    explicit extendable_weak_set(std::size_t slot_count);
+
+    extendable_weak_set(const extendable_weak_set&) = delete;
+    extendable_weak_set& operator=(const extendable_weak_set&) = delete;
+
+    /**
+     * @return false if the extender is already in the set, its resource is
+     * not accessible or no slot is free
+     */
+    bool insert(const weak_extender<T>&);
+    /**
+     * @return false if the extender is not in the set
+     */
+    bool erase(const weak_extender<T>&);
+    /**
+     * @brief Whether the extender is in the set and its resource was not
+     * marked for destruction
+     */
+    bool contains(const weak_extender<T>&) const;
+    /**
+     * @brief Calls function(const weak_extender<T>&) for every entry whose
+     * resource was not marked for destruction
+     * @details The function may lock the extender but must not insert into or
+     * erase from the set. Entries inserted or erased concurrently may or may
+     * not be visited.
+     */
+    template <typename Function>
+    void for_each(Function) const;
+
+    /**
+     * @brief Number of the entries including the ones not pruned yet
+     */
+    std::size_t size() const;
+
+private:
+    /**
+     * @brief Kind of a slot in the low bits of its state, the rest counts the
+     * threads that iterate a full slot
+     */
+    enum : std::uint32_t {
+        empty = 0,
+        busy = 1,
+        full = 2,
+        erased = 3,
+        kind_mask = 3,
+        reader = 4
+    };
+
+    struct slot {
+        std::atomic<const void*> owner{nullptr};
+        std::atomic<std::uint32_t> state{empty};
+        /**
+         * @brief Written only while the slot is busy
+         */
+        weak_extender<T> extender;
+    };
+
+    static bool accessible(const weak_extender<T>&);
+
+    slot& first_slot(const weak_extender<T>&) const;
+    slot& next_slot(const slot&) const;
+    slot& previous_slot(const slot&) const;
+    /**
+     * @brief Erases the entry, waits for the threads that iterate it if asked
+     * to, requires the writers mutex
+     * @return false if the slot is still iterated and was not waited for
+     */
+    bool remove(slot&, bool wait) const;
+    /**
+     * @brief Empties the erased slots that end at an empty slot, going back
+     * from the given one, requires the writers mutex
+     * @details Probes stop at the empty slot anyway, so no lookup can tell
+     * the difference, not even a concurrent one.
+     */
+    void reclaim(slot&) const;
+    /**
+     * @brief Erases the entry if its resource is no longer accessible and no
+     * thread iterates it, requires the writers mutex
+     */
+    bool try_prune(slot&) const;
+
+    std::size_t mask;
+    std::unique_ptr<slot[]> slots;
+    mutable std::atomic<std::size_t> count{0};
+    mutable std::mutex writers;
+};
+
+#include "extendable_weak_set_impl.h"
+
+#endif // _EXTENDABLE_WEAK_SET_
@@ -0,0 +1,205 @@
+#ifndef _EXTENDABLE_WEAK_SET_IMPL_
+#define _EXTENDABLE_WEAK_SET_IMPL_
+
+#include <thread>
+
+template <typename T>
+extendable_weak_set<T>::extendable_weak_set(std::size_t slot_count)
+    : mask(1) {
+    while (mask < slot_count) {
+        mask <<= 1;
+    }
+    slots.reset(new slot[mask]);
+    --mask;
+}
+
+template <typename T>
+bool extendable_weak_set<T>::insert(const weak_extender<T>& extender) {
+    if (!accessible(extender)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(writers);
+    slot* reusable = nullptr;
+    auto* probed = &first_slot(extender);
+    // the whole chain up to an empty slot is checked for the owner, only
+    // then an erased slot in it may be reused
+    for (std::size_t step = 0; step <= mask; ++step, probed = &next_slot(*probed)) {
+        const auto kind = probed->state.load(std::memory_order_acquire) & kind_mask;
+        if (kind == empty) {
+            if (reusable == nullptr) {
+                reusable = probed;
+            }
+            break;
+        }
+        if (kind == full) {
+            if (probed->owner.load(std::memory_order_relaxed) == extender.owner()) {
+                return false;
+            }
+            if (!try_prune(*probed)) {
+                continue;
+            }
+        }
+        if (reusable == nullptr) {
+            reusable = probed;
+        }
+    }
+    if (reusable == nullptr) {
+        return false;
+    }
+
+    reusable->state.store(busy, std::memory_order_relaxed);
+    reusable->extender = extender;
+    reusable->owner.store(extender.owner(), std::memory_order_relaxed);
+    reusable->state.store(full, std::memory_order_release);
+    count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename T>
+bool extendable_weak_set<T>::erase(const weak_extender<T>& extender) {
+    if (extender.owner() == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(writers);
+    auto* probed = &first_slot(extender);
+    for (std::size_t step = 0; step <= mask; ++step, probed = &next_slot(*probed)) {
+        const auto kind = probed->state.load(std::memory_order_acquire) & kind_mask;
+        if (kind == empty) {
+            return false;
+        }
+        if (kind != full) {
+            continue;
+        }
+        if (probed->owner.load(std::memory_order_relaxed) == extender.owner()) {
+            return remove(*probed, true);
+        }
+        try_prune(*probed);
+    }
+    return false;
+}
+
+template <typename T>
+bool extendable_weak_set<T>::contains(const weak_extender<T>& extender) const {
+    if (extender.owner() == nullptr) {
+        return false;
+    }
+    auto* probed = &first_slot(extender);
+    for (std::size_t step = 0; step <= mask; ++step, probed = &next_slot(*probed)) {
+        const auto kind = probed->state.load(std::memory_order_acquire) & kind_mask;
+        if (kind == empty) {
+            return false;
+        }
+        // the caller's extender keeps the owner alive, so it is checked
+        // instead of the stored one
+        if (kind == full && probed->owner.load(std::memory_order_relaxed) == extender.owner()) {
+            return accessible(extender);
+        }
+    }
+    return false;
+}
+
+template <typename T>
+template <typename Function>
+void extendable_weak_set<T>::for_each(Function function) const {
+    struct reading {
+        ~reading() {
+            visited.state.fetch_sub(reader, std::memory_order_release);
+        }
+        slot& visited;
+    };
+
+    for (std::size_t index = 0; index <= mask; ++index) {
+        auto& visited = slots[index];
+        auto state = visited.state.load(std::memory_order_relaxed);
+        bool entered = false;
+        while ((state & kind_mask) == full && !entered) {
+            entered = visited.state.compare_exchange_weak(
+                state, state + reader, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+        if (!entered) {
+            continue;
+        }
+
+        bool alive;
+        {
+            const reading guard{visited};
+            alive = accessible(visited.extender);
+            if (alive) {
+                function(static_cast<const weak_extender<T>&>(visited.extender));
+            }
+        }
+        if (!alive) {
+            std::unique_lock<std::mutex> lock(writers, std::try_to_lock);
+            if (lock.owns_lock()) {
+                try_prune(visited);
+            }
+        }
+    }
+}
+
+template <typename T>
+std::size_t extendable_weak_set<T>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+/*static*/ bool extendable_weak_set<T>::accessible(const weak_extender<T>& extender) {
+    return extender.accessible_in_scope();
+}
+
+template <typename T>
+typename extendable_weak_set<T>::slot& extendable_weak_set<T>::first_slot(const weak_extender<T>& extender) const {
+    return slots[owner_hash()(extender) & mask];
+}
+
+template <typename T>
+typename extendable_weak_set<T>::slot& extendable_weak_set<T>::next_slot(const slot& current) const {
+    return slots[(&current - slots.get() + 1) & mask];
+}
+
+template <typename T>
+typename extendable_weak_set<T>::slot& extendable_weak_set<T>::previous_slot(const slot& current) const {
+    return slots[(&current - slots.get() - 1) & mask];
+}
+
+template <typename T>
+bool extendable_weak_set<T>::remove(slot& removed, bool wait) const {
+    auto expected = std::uint32_t(full);
+    while (!removed.state.compare_exchange_strong(expected, busy, std::memory_order_acquire)) {
+        if (!wait) {
+            return false;
+        }
+        expected = full;
+        std::this_thread::yield();
+    }
+    removed.extender.reset();
+    removed.owner.store(nullptr, std::memory_order_relaxed);
+    removed.state.store(erased, std::memory_order_release);
+    count.fetch_sub(1, std::memory_order_relaxed);
+    reclaim(removed);
+    return true;
+}
+
+template <typename T>
+void extendable_weak_set<T>::reclaim(slot& last) const {
+    // every run of erased slots ends at a full one otherwise, once the set
+    // is empty no slot is full and either none is empty or none is erased
+    if ((next_slot(last).state.load(std::memory_order_relaxed) & kind_mask) != empty
+        && count.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    auto* reclaimed = &last;
+    for (std::size_t step = 0; step <= mask; ++step, reclaimed = &previous_slot(*reclaimed)) {
+        if ((reclaimed->state.load(std::memory_order_relaxed) & kind_mask) != erased) {
+            return;
+        }
+        reclaimed->state.store(empty, std::memory_order_release);
+    }
+}
+
+template <typename T>
+bool extendable_weak_set<T>::try_prune(slot& pruned) const {
+    return !accessible(pruned.extender) && remove(pruned, false);
+}
+
+#endif // _EXTENDABLE_WEAK_SET_IMPL_
@@ -0,0 +1,46 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_group.h"
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct single {};
+struct member {};
+
+template <typename T>
+void expect_gauges(std::int64_t live_resources, std::int64_t control_blocks, std::int64_t dead_control_blocks) {
+    const auto snapshot = extendable_accounting<T>::snapshot();
+    EXPECT_EQ(snapshot.live_resources, live_resources);
+    EXPECT_EQ(snapshot.control_blocks, control_blocks);
+    EXPECT_EQ(snapshot.dead_control_blocks, dead_control_blocks);
+}
+
+TEST(accounting, weak_extender_keeps_a_dead_control_block) {
+    auto owner = make_unique_extendable<single>();
+    weak_extender<single> weak(owner);
+    expect_gauges<single>(1, 1, 0);
+    owner.reset();
+    expect_gauges<single>(0, 1, 1);
+    weak.reset();
+    expect_gauges<single>(0, 0, 0);
+}
+
+TEST(accounting, group_is_a_single_control_block) {
+    std::vector<std::unique_ptr<member>> resources;
+    for (int i = 0; i < 10; ++i) {
+        resources.push_back(std::unique_ptr<member>(new member));
+    }
+    extendable_group<member> group(std::move(resources));
+    auto weak = group.extender(3);
+    expect_gauges<member>(10, 1, 0);
+    group.reset();
+    expect_gauges<member>(0, 1, 1);
+    weak.reset();
+    expect_gauges<member>(0, 0, 0);
+}
+
+} // namespace
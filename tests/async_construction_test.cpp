@@ -0,0 +1,105 @@
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct manual_executor {
+    void submit(std::function<void()> task) { tasks.push_back(std::move(task)); }
+
+    void run() {
+        for (auto& task : tasks) {
+            task();
+        }
+        tasks.clear();
+    }
+
+    std::vector<std::function<void()>> tasks;
+};
+
+struct throwing {
+    explicit throwing(bool fail) {
+        if (fail) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+};
+
+std::string message_of(const std::exception_ptr& error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::runtime_error& thrown) {
+        return thrown.what();
+    }
+    return std::string();
+}
+
+TEST(async_construction, failure_is_passed_to_the_continuations) {
+    manual_executor executor;
+    auto owner = make_unique_extendable_async<throwing>(executor, true);
+    weak_extender<throwing> weak(owner);
+    std::exception_ptr waited;
+    weak.when_ready([&](std::exception_ptr error) { waited = error; });
+    EXPECT_TRUE(weak.pending());
+    EXPECT_FALSE(weak.failed());
+
+    executor.run();
+    EXPECT_FALSE(weak.pending());
+    EXPECT_TRUE(weak.failed());
+    ASSERT_NE(waited, nullptr);
+    EXPECT_EQ(message_of(waited), "construction failed");
+    EXPECT_TRUE(weak.lock().empty());
+    EXPECT_EQ(owner.get(), nullptr);
+
+    std::exception_ptr late;
+    weak.when_ready([&](std::exception_ptr error) { late = error; });
+    EXPECT_EQ(late, waited);
+    EXPECT_EQ(weak.construction_error(), waited);
+
+    owner.reset();
+    EXPECT_EQ(weak.construction_error(), nullptr);
+}
+
+TEST(async_construction, success_has_no_error) {
+    manual_executor executor;
+    auto owner = make_unique_extendable_async<throwing>(executor, false);
+    weak_extender<throwing> weak(owner);
+    bool ready = false;
+    std::exception_ptr waited = std::make_exception_ptr(std::runtime_error("not called"));
+    weak.when_ready([&] { ready = true; });
+    weak.when_ready([&](std::exception_ptr error) { waited = error; });
+
+    executor.run();
+    EXPECT_TRUE(ready);
+    EXPECT_EQ(waited, nullptr);
+    EXPECT_FALSE(weak.failed());
+    EXPECT_EQ(weak.construction_error(), nullptr);
+    EXPECT_FALSE(weak.lock().empty());
+}
+
+TEST(async_construction, completion_runs_only_its_own_continuations) {
+    manual_executor first_executor;
+    manual_executor second_executor;
+    auto first = make_unique_extendable_async<throwing>(first_executor, false);
+    auto second = make_unique_extendable_async<throwing>(second_executor, true);
+    int first_ready = 0;
+    int second_ready = 0;
+    for (int i = 0; i < 3; ++i) {
+        weak_extender<throwing>(first).when_ready([&] { ++first_ready; });
+        weak_extender<throwing>(second).when_ready([&] { ++second_ready; });
+    }
+
+    second_executor.run();
+    EXPECT_EQ(first_ready, 0);
+    EXPECT_EQ(second_ready, 3);
+    first_executor.run();
+    EXPECT_EQ(first_ready, 3);
+}
+
+} // namespace
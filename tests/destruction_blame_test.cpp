@@ -0,0 +1,98 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct blamed {};
+struct other {};
+
+/**
+ * @brief The only entry recorded since the blame was cleared
+ */
+destruction_blame_entry only_offender() {
+    const auto entries = destruction_blame::top_offenders(10);
+    EXPECT_EQ(entries.size(), 1u);
+    return entries.empty() ? destruction_blame_entry{} : entries[0];
+}
+
+TEST(destruction_blame, blames_the_last_extender) {
+    destruction_blame::clear();
+    auto owner = make_unique_extendable<blamed>();
+    weak_extender<blamed> weak(owner);
+    std::uint_least32_t line = 0;
+    {
+        line = __LINE__ + 1;
+        const auto& extender = weak.lock();
+        owner.reset();
+    }
+
+    const auto entry = only_offender();
+    EXPECT_EQ(entry.line, line);
+    EXPECT_EQ(entry.thread, std::this_thread::get_id());
+    EXPECT_EQ(entry.delayed_destructions, 1u);
+}
+
+TEST(destruction_blame, parked_reference_keeps_the_call_site) {
+    destruction_blame::clear();
+    auto owner = make_unique_extendable<blamed>();
+    weak_extender<blamed> weak(owner);
+    std::uint_least32_t line = 0;
+    {
+        line = __LINE__ + 1;
+        auto&& outer = weak.lock();
+        const auto& nested = weak.lock();
+        owner.reset();
+        // parks the reference for the nested extender, which destroys the resource
+        outer.reset();
+        EXPECT_TRUE(destruction_blame::top_offenders(10).empty());
+    }
+
+    const auto entry = only_offender();
+    EXPECT_EQ(entry.line, line);
+    EXPECT_EQ(entry.delayed_destructions, 1u);
+}
+
+TEST(destruction_blame, remote_release_keeps_the_call_site) {
+    destruction_blame::clear();
+    auto owner = make_unique_extendable<blamed>();
+    auto unrelated = make_unique_extendable<other>();
+    weak_extender<blamed> weak(owner);
+    weak_extender<other> weak_unrelated(unrelated);
+    std::atomic<scoped_extender<blamed>*> locked{nullptr};
+    std::atomic<bool> released{false};
+    std::atomic<std::uint_least32_t> line{0};
+    std::thread::id registering;
+
+    std::thread locking([&] {
+        registering = std::this_thread::get_id();
+        line = __LINE__ + 1;
+        auto&& extender = weak.lock();
+        locked = &extender;
+        while (!released.load()) {
+            std::this_thread::yield();
+        }
+        // applies the release queued by the other thread
+        EXPECT_FALSE(weak_unrelated.lock().empty());
+        EXPECT_EQ(destruction_blame::top_offenders(10).size(), 1u);
+    });
+    while (locked.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    owner.reset();
+    locked.load()->reset();
+    EXPECT_TRUE(destruction_blame::top_offenders(10).empty());
+    released = true;
+    locking.join();
+
+    const auto entry = only_offender();
+    EXPECT_EQ(entry.line, line.load());
+    EXPECT_EQ(entry.thread, registering);
+    EXPECT_EQ(entry.delayed_destructions, 1u);
+}
+
+} // namespace
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+class gate {
+public:
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        condition.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return opened; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool opened = false;
+};
+
+TEST(extension_scope, destroys_right_away_without_an_open_scope) {
+    auto owner = make_unique_extendable<counted>(1);
+    owner.reset();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(extension_scope, defers_the_destruction_until_the_scope_closes) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    {
+        const auto& scope = extension_scope::open();
+        const auto& scoped = weak.lock(scope);
+        ASSERT_FALSE(scoped.empty());
+        owner.reset();
+        EXPECT_EQ(scoped->value, 1);
+        EXPECT_EQ(counted::alive.load(), 1);
+        EXPECT_TRUE(weak.lock(scope).empty());
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(extension_scope, a_scope_opened_later_does_not_hold_the_destruction_back) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    gate later_opened;
+    gate earlier_closed;
+    std::thread later;
+    {
+        const auto& scope = extension_scope::open();
+        owner.reset();
+        later = std::thread([&] {
+            const auto& later_scope = extension_scope::open();
+            EXPECT_TRUE(weak.lock(later_scope).empty());
+            later_opened.open();
+            earlier_closed.wait();
+        });
+        later_opened.wait();
+        EXPECT_EQ(counted::alive.load(), 1);
+    }
+    // the scope of the other thread is still open
+    EXPECT_EQ(counted::alive.load(), 0);
+    earlier_closed.open();
+    later.join();
+}
+
+TEST(extension_scope, nested_scopes_defer_until_the_outermost_closes) {
+    auto owner = make_unique_extendable<counted>(1);
+    {
+        const auto& outer = extension_scope::open();
+        {
+            const auto& inner = extension_scope::open();
+            owner.reset();
+        }
+        EXPECT_EQ(counted::alive.load(), 1);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(extension_scope, destructions_progress_while_scopes_overlap) {
+    constexpr int readers = 3;
+    constexpr int resources = 512;
+    constexpr int batch = 64;
+    std::vector<unique_extendable_ptr<counted>> owners;
+    std::vector<weak_extender<counted>> weaks;
+    for (int i = 0; i < resources; ++i) {
+        owners.push_back(make_unique_extendable<counted>(i));
+        weaks.emplace_back(owners.back());
+    }
+
+    std::atomic_bool running{true};
+    std::vector<std::atomic<int>> closed(readers);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; ++t) {
+        closed[t].store(0);
+        threads.emplace_back([&, t] {
+            std::size_t index = t;
+            while (running.load()) {
+                {
+                    const auto& scope = extension_scope::open();
+                    for (int i = 0; i < 16; ++i, index = (index + 7) % resources) {
+                        const auto& scoped = weaks[index].lock(scope);
+                        if (!scoped.empty()) {
+                            EXPECT_EQ(scoped->value, static_cast<int>(index));
+                        }
+                    }
+                    std::this_thread::yield();
+                }
+                ++closed[t];
+            }
+        });
+    }
+
+    for (int released = 0; released < resources;) {
+        for (int i = 0; i < batch; ++i, ++released) {
+            owners[released].reset();
+        }
+        // once every scope that was open during the releases has closed, the
+        // releases are destroyed even though other scopes are open by then
+        for (int t = 0; t < readers; ++t) {
+            const auto target = closed[t].load() + 2;
+            while (closed[t].load() < target) {
+                std::this_thread::yield();
+            }
+        }
+        EXPECT_EQ(counted::alive.load(), resources - released);
+    }
+    running.store(false);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_group.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+extendable_group<counted> make_group(int size) {
+    std::vector<std::unique_ptr<counted>> resources;
+    for (int i = 0; i < size; ++i) {
+        resources.push_back(std::unique_ptr<counted>(new counted(i)));
+    }
+    return extendable_group<counted>(std::move(resources));
+}
+
+TEST(extendable_group, member_lock_keeps_the_whole_group) {
+    auto group = make_group(3);
+    auto weak = group.extender(1);
+    {
+        const auto& extender = weak.lock();
+        ASSERT_FALSE(extender.empty());
+        group.reset();
+        EXPECT_EQ(extender->value, 1);
+        EXPECT_EQ(counted::alive.load(), 3);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(extendable_group, reset_marks_every_member) {
+    auto group = make_group(3);
+    std::vector<weak_extender<counted>> members;
+    for (std::size_t i = 0; i < group.size(); ++i) {
+        members.push_back(group.extender(i));
+    }
+    {
+        const auto& extender = members[0].lock();
+        group.reset();
+        for (const auto& member : members) {
+            EXPECT_TRUE(member.lock().empty());
+        }
+        const auto& scope = extension_scope::open();
+        for (const auto& member : members) {
+            EXPECT_TRUE(member.lock(scope).empty());
+        }
+        EXPECT_EQ(counted::alive.load(), 3);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(extendable_group, members_outlive_the_last_extender) {
+    auto group = make_group(3);
+    auto scoped_member = group.extender(0);
+    auto pinned_member = group.extender(2);
+    {
+        real_time_thread rt;
+        const auto& pinned = pinned_member.lock(rt);
+        ASSERT_FALSE(pinned.empty());
+        {
+            const auto& extender = scoped_member.lock();
+            group.reset();
+            EXPECT_EQ(counted::alive.load(), 3);
+        }
+        // the pin on another member still keeps the whole group
+        EXPECT_EQ(counted::alive.load(), 3);
+        EXPECT_EQ(pinned->value, 2);
+    }
+    // the real-time thread handed the destruction over
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+} // namespace
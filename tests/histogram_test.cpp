@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct held {};
+struct delayed {};
+
+TEST(histogram_snapshot, buckets_bound_the_relative_error) {
+    for (std::uint64_t value = 0; value < (std::uint64_t(1) << 20); value = value * 9 / 8 + 1) {
+        const auto index = histogram_snapshot::bucket_index(value);
+        ASSERT_LT(index, histogram_snapshot::bucket_count);
+        const auto upper = histogram_snapshot::bucket_upper_bound(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 4) << value;
+        if (index != 0) {
+            EXPECT_LT(histogram_snapshot::bucket_upper_bound(index - 1), value);
+        }
+    }
+    const auto largest = ~std::uint64_t(0);
+    ASSERT_LT(histogram_snapshot::bucket_index(largest), histogram_snapshot::bucket_count);
+    EXPECT_EQ(histogram_snapshot::bucket_upper_bound(histogram_snapshot::bucket_index(largest)), largest);
+}
+
+TEST(histogram_snapshot, percentiles_of_recorded_values) {
+    latency_histogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(50), 0u);
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.max, 1000u);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 500.5);
+    EXPECT_EQ(snapshot.percentile(0), 1u);
+    EXPECT_EQ(snapshot.percentile(100), 1000u);
+    for (double percentile : {50.0, 90.0, 99.0}) {
+        const auto exact = static_cast<std::uint64_t>(percentile * 10);
+        EXPECT_GE(snapshot.percentile(percentile), exact);
+        EXPECT_LE(snapshot.percentile(percentile), exact + exact / 4);
+    }
+
+    histogram_snapshot merged;
+    merged.merge(snapshot);
+    merged.merge(snapshot);
+    EXPECT_EQ(merged.count, 2000u);
+    EXPECT_EQ(merged.percentile(50), snapshot.percentile(50));
+}
+
+TEST(extendable_histograms, records_hold_time) {
+    auto owner = make_unique_extendable<held>();
+    weak_extender<held> weak(owner);
+    {
+        const auto& extender = weak.lock();
+        ASSERT_FALSE(extender.empty());
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const auto snapshot = extendable_histograms<held>::snapshot();
+    EXPECT_EQ(snapshot.hold_ns.count, 1u);
+    EXPECT_GE(snapshot.hold_ns.max, 2000000u);
+    EXPECT_EQ(snapshot.destruction_delay_ns.count, 0u);
+}
+
+TEST(extendable_histograms, records_destruction_delay) {
+    auto owner = make_unique_extendable<delayed>();
+    weak_extender<delayed> weak(owner);
+    {
+        const auto& extender = weak.lock();
+        owner.reset();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    const auto snapshot = extendable_histograms<delayed>::snapshot();
+    EXPECT_EQ(snapshot.destruction_delay_ns.count, 1u);
+    EXPECT_GE(snapshot.destruction_delay_ns.max, 2000000u);
+}
+
+} // namespace
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_index.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) {}
+
+    int value;
+};
+
+constexpr int slot_count = 1 << 12;
+
+struct resources {
+    explicit resources(int count) {
+        for (int i = 0; i < count; ++i) {
+            owners.push_back(make_unique_extendable<counted>(i));
+            extenders.emplace_back(owners.back());
+        }
+    }
+
+    std::vector<unique_extendable_ptr<counted>> owners;
+    std::vector<weak_extender<counted>> extenders;
+};
+
+/**
+ * @brief The fastest of a few rounds of lookups of keys that are not in the
+ * index, they hash to the slots of the keys below slot_count
+ */
+std::chrono::nanoseconds missing_lookups(const extendable_index<int, counted>& index) {
+    auto fastest = std::chrono::nanoseconds::max();
+    for (int round = 0; round < 5; ++round) {
+        const auto started = std::chrono::steady_clock::now();
+        int found = 0;
+        for (int key = slot_count; key < slot_count + 256; ++key) {
+            found += index.find(key).owner() != nullptr ? 1 : 0;
+        }
+        fastest = std::min(fastest, std::chrono::steady_clock::now() - started);
+        EXPECT_EQ(found, 0);
+    }
+    return fastest;
+}
+
+TEST(extendable_index, reset_drops_the_entry) {
+    extendable_index<int, counted> index(16);
+    resources stored(2);
+    ASSERT_TRUE(index.insert(1, stored.extenders[0]));
+    ASSERT_TRUE(index.insert(2, stored.extenders[1]));
+    stored.owners[0].reset();
+    EXPECT_EQ(index.find(1).owner(), nullptr);
+    EXPECT_EQ(index.find(2).owner(), stored.extenders[1].owner());
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(extendable_index, erased_slots_are_reused) {
+    extendable_index<int, counted> index(slot_count);
+    resources stored(slot_count);
+    for (int round = 0; round < 3; ++round) {
+        for (int key = 0; key < slot_count; ++key) {
+            EXPECT_TRUE(index.insert(key, stored.extenders[static_cast<std::size_t>(key)]));
+        }
+        EXPECT_EQ(index.size(), static_cast<std::size_t>(slot_count));
+        for (int key = 0; key < slot_count; ++key) {
+            EXPECT_TRUE(index.erase(key));
+        }
+        EXPECT_EQ(index.size(), 0u);
+    }
+}
+
+TEST(extendable_index, lookup_miss_stays_short_after_churn) {
+    resources stored(slot_count);
+    extendable_index<int, counted> fresh(slot_count);
+    extendable_index<int, counted> churned(slot_count);
+    for (int key = 0; key < slot_count; ++key) {
+        churned.insert(key, stored.extenders[static_cast<std::size_t>(key)]);
+    }
+    // erased in two passes, so that the first one leaves erased slots followed by full ones
+    for (int key = 0; key < slot_count; key += 2) {
+        churned.erase(key);
+    }
+    // the rest is dropped by the resets
+    for (int key = 1; key < slot_count; key += 2) {
+        stored.owners[static_cast<std::size_t>(key)].reset();
+    }
+    EXPECT_EQ(churned.size(), 0u);
+
+    // every miss used to walk the whole table of erased slots
+    EXPECT_LT(missing_lookups(churned), 10 * missing_lookups(fresh));
+}
+
+TEST(extendable_index, lookups_find_kept_entries_while_others_churn) {
+    extendable_index<int, counted> index(256);
+    resources kept(32);
+    std::atomic<bool> stop{false};
+    std::atomic<int> missed{0};
+    for (int key = 0; key < 32; ++key) {
+        ASSERT_TRUE(index.insert(key, kept.extenders[static_cast<std::size_t>(key)]));
+    }
+
+    std::thread reader([&] {
+        while (!stop.load()) {
+            for (int key = 0; key < 32; ++key) {
+                if (index.find(key).owner() != kept.extenders[static_cast<std::size_t>(key)].owner()) {
+                    ++missed;
+                }
+            }
+        }
+    });
+    // resets of other resources, each in a thread of its own, drop their entries concurrently
+    for (int round = 0; round < 200; ++round) {
+        resources churned(96);
+        for (int i = 0; i < 96; ++i) {
+            index.insert(1000 + i, churned.extenders[static_cast<std::size_t>(i)]);
+        }
+        std::thread first([&] {
+            for (int i = 0; i < 96; i += 2) {
+                churned.owners[static_cast<std::size_t>(i)].reset();
+            }
+        });
+        for (int i = 1; i < 96; i += 2) {
+            churned.owners[static_cast<std::size_t>(i)].reset();
+        }
+        first.join();
+    }
+    stop = true;
+    reader.join();
+    EXPECT_EQ(missed.load(), 0);
+    EXPECT_EQ(index.size(), 32u);
+}
+
+} // namespace
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "extendable_lease.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+TEST(lease, expires_at_its_deadline) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    auto leased = weak.lease_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(20));
+    ASSERT_FALSE(leased.expired());
+
+    lease_reaper::reap();
+    EXPECT_FALSE(leased.expired());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lease_reaper::reap();
+    EXPECT_TRUE(leased.expired());
+    const auto& scope = extension_scope::open();
+    EXPECT_EQ(leased.get(scope), nullptr);
+}
+
+TEST(lease, expires_when_its_frames_are_over) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    auto leased = weak.lease_for_frames(2);
+
+    lease_reaper::advance_frame();
+    EXPECT_FALSE(leased.expired());
+    lease_reaper::advance_frame();
+    EXPECT_TRUE(leased.expired());
+}
+
+TEST(lease, keeps_the_reset_resource_until_it_expires) {
+    auto owner = make_unique_extendable<counted>(7);
+    weak_extender<counted> weak(owner);
+    auto leased = weak.lease_for_frames(1);
+    owner.reset();
+    EXPECT_EQ(counted::alive.load(), 1);
+    EXPECT_TRUE(weak.lock().empty());
+    {
+        const auto& scope = extension_scope::open();
+        ASSERT_NE(leased.get(scope), nullptr);
+        EXPECT_EQ(leased.get(scope)->value, 7);
+    }
+
+    lease_reaper::advance_frame();
+    EXPECT_EQ(counted::alive.load(), 0);
+    const auto& scope = extension_scope::open();
+    EXPECT_EQ(leased.get(scope), nullptr);
+}
+
+TEST(lease, no_lease_of_a_reset_resource) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    owner.reset();
+    EXPECT_TRUE(weak.lease_for_frames(1).expired());
+}
+
+TEST(lease, counts_the_leases) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    EXPECT_EQ(owner.leases(), 0u);
+    auto first = weak.lease_for_frames(1);
+    auto second = weak.lease_for_frames(100);
+    EXPECT_EQ(owner.leases(), 2u);
+
+    first.reset();
+    EXPECT_EQ(owner.leases(), 1u);
+    lease_reaper::advance_frame();
+    EXPECT_EQ(owner.leases(), 1u);
+    second = weak.lease_for_frames(1);
+    EXPECT_EQ(owner.leases(), 1u);
+    lease_reaper::advance_frame();
+    EXPECT_EQ(owner.leases(), 0u);
+}
+
+TEST(lease_reaper, thread_releases_the_resource) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    auto leased = weak.lease_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(5));
+    owner.reset();
+
+    lease_reaper::start(std::chrono::milliseconds(1));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (counted::alive.load() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    lease_reaper::stop();
+    EXPECT_EQ(counted::alive.load(), 0);
+    EXPECT_TRUE(leased.expired());
+}
+
+TEST(lease_reaper, exit_without_stop) {
+    EXPECT_EXIT(
+        {
+            lease_reaper::start();
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "");
+}
+
+} // namespace
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct held {};
+
+/**
+ * @brief Runs the detector with a short threshold and collects its reports
+ */
+class detector_run {
+public:
+    detector_run() {
+        long_hold_detector::start(
+            std::chrono::milliseconds(1),
+            std::chrono::milliseconds(1),
+            [this](const long_hold_report& report) {
+                std::lock_guard<std::mutex> lock(mutex);
+                reports.push_back(report);
+            });
+    }
+
+    ~detector_run() { long_hold_detector::stop(); }
+
+    std::vector<long_hold_report> collected() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return reports;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<long_hold_report> reports;
+};
+
+TEST(long_hold_detector, reports_a_long_hold_once) {
+    auto owner = make_unique_extendable<held>();
+    weak_extender<held> weak(owner);
+    detector_run run;
+    int line = 0;
+    {
+        line = __LINE__ + 1;
+        const auto& extender = weak.lock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    const auto reports = run.collected();
+    ASSERT_EQ(reports.size(), 1u);
+    EXPECT_EQ(reports[0].line, static_cast<std::uint_least32_t>(line));
+    EXPECT_NE(std::strstr(reports[0].file_name, "long_hold_test.cpp"), nullptr);
+    EXPECT_EQ(reports[0].thread, std::this_thread::get_id());
+    EXPECT_GE(reports[0].held_for, std::chrono::milliseconds(1));
+}
+
+TEST(long_hold_detector, hold_released_on_another_thread_ends) {
+    auto owner = make_unique_extendable<held>();
+    weak_extender<held> weak(owner);
+    std::atomic<scoped_extender<held>*> locked{nullptr};
+    std::atomic<bool> released{false};
+    std::atomic<bool> finished{false};
+    // the locking thread stays alive, so its table is scanned
+    std::thread locking([&] {
+        auto&& extender = weak.lock();
+        locked = &extender;
+        while (!released.load()) {
+            std::this_thread::yield();
+        }
+        while (!finished.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (locked.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    locked.load()->reset();
+    released = true;
+
+    {
+        detector_run run;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_TRUE(run.collected().empty());
+    }
+    finished = true;
+    locking.join();
+}
+
+TEST(long_hold_detector, exit_without_stop) {
+    EXPECT_EXIT(
+        {
+            long_hold_detector::start(std::chrono::milliseconds(1));
+            std::exit(0);
+        },
+        ::testing::ExitedWithCode(0),
+        "");
+}
+
+} // namespace
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_parallel.h"
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+constexpr int element_count = 2000;
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() {
+        destroyed[value] = true;
+        --alive;
+    }
+
+    static std::atomic<int> alive;
+    static std::vector<std::atomic<bool>> destroyed;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+std::vector<std::atomic<bool>> counted::destroyed(element_count);
+
+std::vector<unique_extendable_ptr<counted>> make_storage() {
+    std::vector<unique_extendable_ptr<counted>> storage;
+    for (int i = 0; i < element_count; ++i) {
+        counted::destroyed[i] = false;
+        storage.push_back(make_unique_extendable<counted>(i));
+    }
+    return storage;
+}
+
+std::vector<weak_extender<counted>> make_extenders(const std::vector<unique_extendable_ptr<counted>>& storage) {
+    std::vector<weak_extender<counted>> extenders;
+    for (const auto& owner : storage) {
+        extenders.emplace_back(owner);
+    }
+    return extenders;
+}
+
+TEST(parallel_for_each, visits_every_element_once) {
+    work_stealing_pool pool(3);
+    auto storage = make_storage();
+    const auto extenders = make_extenders(storage);
+    for (const std::size_t chunk_size : {std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(5000)}) {
+        std::vector<std::atomic<int>> visits(element_count);
+        parallel_for_each(pool, storage, [&](counted& element) { ++visits[element.value]; }, chunk_size);
+        parallel_for_each(pool, extenders, [&](counted& element) { ++visits[element.value]; }, chunk_size);
+        for (const auto& element : visits) {
+            EXPECT_EQ(element.load(), 2);
+        }
+    }
+}
+
+TEST(parallel_for_each, skips_the_elements_reset_by_their_owners) {
+    work_stealing_pool pool(3);
+    auto storage = make_storage();
+    const auto extenders = make_extenders(storage);
+    for (int i = 0; i < element_count; i += 2) {
+        storage[i].reset();
+    }
+    std::atomic<bool> started{false};
+    std::atomic<int> visited_even{0};
+    std::atomic<int> destroyed_while_visited{0};
+    // the odd elements are reset while they are visited
+    std::thread owner([&] {
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        for (int i = 1; i < element_count; i += 2) {
+            storage[i].reset();
+        }
+    });
+    parallel_for_each(
+        pool,
+        extenders,
+        [&](counted& element) {
+            started = true;
+            if (element.value % 2 == 0) {
+                ++visited_even;
+            }
+            std::this_thread::yield();
+            if (counted::destroyed[element.value].load()) {
+                ++destroyed_while_visited;
+            }
+        },
+        16);
+    owner.join();
+
+    EXPECT_EQ(visited_even.load(), 0);
+    EXPECT_EQ(destroyed_while_visited.load(), 0);
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(parallel_for_each, rethrows_after_every_chunk_is_done) {
+    work_stealing_pool pool(3);
+    auto storage = make_storage();
+    std::atomic<int> visited{0};
+    EXPECT_THROW(
+        parallel_for_each(
+            pool,
+            storage,
+            [&](counted& element) {
+                ++visited;
+                if (element.value % 100 == 0) {
+                    throw std::runtime_error("element");
+                }
+            },
+            10),
+        std::runtime_error);
+    // a throwing element ends only its own chunk
+    EXPECT_EQ(visited.load(), element_count - (element_count / 100) * 9);
+
+    // the pool is still usable
+    visited = 0;
+    parallel_for_each(pool, storage, [&](counted&) { ++visited; }, 10);
+    EXPECT_EQ(visited.load(), element_count);
+}
+
+} // namespace
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+TEST(real_time_thread, pinned_lock_keeps_the_resource_alive) {
+    real_time_thread rt;
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    {
+        const auto& pinned = weak.lock(rt);
+        ASSERT_FALSE(pinned.empty());
+        owner.reset();
+        EXPECT_EQ(pinned->value, 1);
+        EXPECT_TRUE(weak.lock(rt).empty());
+    }
+    // the real-time thread handed the destruction over
+    EXPECT_EQ(counted::alive.load(), 1);
+    weak.reset();
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(real_time_thread, pinned_lock_fails_once_released) {
+    real_time_thread rt;
+    weak_extender<counted> weak;
+    EXPECT_TRUE(weak.lock(rt).empty());
+    {
+        auto owner = make_unique_extendable<counted>(1);
+        weak = weak_extender<counted>(owner);
+    }
+    EXPECT_TRUE(weak.lock(rt).empty());
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+    EXPECT_TRUE(weak.lock(rt).empty());
+    weak.reset();
+    real_time_thread::reclaim();
+}
+
+TEST(real_time_thread, last_pin_releases_on_another_thread) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    {
+        real_time_thread rt;
+        const auto& first = weak.lock(rt);
+        const auto& second = weak.lock(rt);
+        ASSERT_FALSE(second.empty());
+        std::thread([&] { owner.reset(); }).join();
+        EXPECT_EQ(first->value, 1);
+    }
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(real_time_thread, pins_are_limited) {
+    real_time_thread rt;
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    std::vector<std::unique_ptr<pinned_extender<counted>>> pins;
+    for (std::size_t i = 0; i < extendable_core::max_pins; ++i) {
+        pins.emplace_back(new pinned_extender<counted>(weak.lock(rt)));
+        ASSERT_FALSE(pins.back()->empty());
+    }
+    EXPECT_TRUE(weak.lock(rt).empty());
+    pins.pop_back();
+    EXPECT_FALSE(weak.lock(rt).empty());
+
+    pins.clear();
+    owner.reset();
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(real_time_thread, pins_race_with_releases) {
+    constexpr int resources = 2000;
+    std::vector<weak_extender<counted>> weaks(resources);
+    std::atomic<int> published{0};
+    std::atomic_bool done{false};
+
+    std::thread real_time([&] {
+        real_time_thread rt;
+        while (!done.load()) {
+            const auto count = published.load();
+            for (int i = count > 4 ? count - 4 : 0; i < count; ++i) {
+                const auto& pinned = weaks[i].lock(rt);
+                if (!pinned.empty()) {
+                    EXPECT_EQ(pinned->value, i);
+                }
+            }
+        }
+    });
+    std::thread reclaimer([&] {
+        while (!done.load()) {
+            real_time_thread::reclaim();
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 0; i < resources; ++i) {
+        auto owner = make_unique_extendable<counted>(i);
+        weaks[i] = weak_extender<counted>(owner);
+        published.store(i + 1);
+        std::this_thread::yield();
+    }
+    done.store(true);
+    real_time.join();
+    reclaimer.join();
+    real_time_thread::reclaim();
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+} // namespace
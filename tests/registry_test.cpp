@@ -0,0 +1,106 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_registry.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+TEST(extendable_registry, erased_resource_is_inaccessible_before_publish) {
+    extendable_registry<counted> registry;
+    const auto kept = registry.insert(make_unique_extendable<counted>(1));
+    const auto erased = registry.insert(make_unique_extendable<counted>(2));
+    registry.publish();
+    {
+        const auto& published = registry.read();
+        ASSERT_EQ(published.size(), 2u);
+        EXPECT_TRUE(registry.erase(erased));
+        EXPECT_FALSE(registry.erase(erased));
+        EXPECT_EQ(published.size(), 2u);
+        EXPECT_TRUE(published[1].lock().empty());
+        EXPECT_FALSE(published[0].lock().empty());
+    }
+    registry.publish();
+    EXPECT_EQ(registry.read().size(), 1u);
+    EXPECT_EQ(registry.read()[0].owner(), kept.owner());
+}
+
+TEST(extendable_registry, readers_race_publish) {
+    constexpr int frames = 500;
+    constexpr std::size_t kept = 64;
+    std::atomic<bool> stop{false};
+    std::atomic<int> torn{0};
+    std::atomic<long> locked{0};
+    {
+        extendable_registry<counted> registry;
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 3; ++i) {
+            readers.emplace_back([&] {
+                std::vector<const void*> first_pass;
+                while (!stop.load()) {
+                    const auto& published = registry.read();
+                    first_pass.clear();
+                    for (const auto& extender : published) {
+                        first_pass.push_back(extender.owner());
+                        const auto& scoped = extender.lock();
+                        if (!scoped.empty()) {
+                            if (scoped->value < 0) {
+                                ++torn;
+                            }
+                            ++locked;
+                        }
+                    }
+                    // a snapshot never changes while it is held
+                    if (first_pass.size() != published.size()) {
+                        ++torn;
+                        continue;
+                    }
+                    for (std::size_t i = 0; i < published.size(); ++i) {
+                        if (published[i].owner() != first_pass[i]) {
+                            ++torn;
+                        }
+                    }
+                }
+            });
+        }
+
+        std::vector<weak_extender<counted>> live;
+        // keeps publishing until the readers got scheduled as well
+        for (int frame = 0; frame < frames || locked.load() < 1000; ++frame) {
+            for (int k = 0; k < 5; ++k) {
+                live.push_back(registry.insert(make_unique_extendable<counted>(frame)));
+            }
+            for (int k = 0; k < 5 && live.size() > kept; ++k) {
+                const auto erased = static_cast<std::size_t>(frame * 7 + k) % live.size();
+                EXPECT_TRUE(registry.erase(live[erased]));
+                live.erase(live.begin() + static_cast<std::ptrdiff_t>(erased));
+            }
+            registry.publish();
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        EXPECT_EQ(registry.read().size(), live.size());
+        for (const auto& extender : live) {
+            EXPECT_FALSE(extender.lock().empty());
+        }
+    }
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_GT(locked.load(), 0);
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+} // namespace
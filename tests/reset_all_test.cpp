@@ -0,0 +1,87 @@
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_parallel.h"
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+std::vector<unique_extendable_ptr<counted>> make_storage(int size) {
+    std::vector<unique_extendable_ptr<counted>> storage;
+    for (int i = 0; i < size; ++i) {
+        storage.push_back(make_unique_extendable<counted>(i));
+    }
+    return storage;
+}
+
+TEST(reset_all, reports_only_the_resources_it_did_not_destroy) {
+    auto storage = make_storage(100);
+    weak_extender<counted> held(storage[3]);
+    weak_extender<counted> failed(storage[4]);
+    {
+        const auto& scoped = held.lock();
+        const auto result = reset_all(storage);
+        EXPECT_EQ(result.reset, 100u);
+        EXPECT_EQ(result.deferred, 1u);
+        EXPECT_EQ(counted::alive.load(), 1);
+        EXPECT_TRUE(failed.lock().empty());
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(reset_all, counts_the_destructions_deferred_by_a_scope) {
+    auto storage = make_storage(10);
+    {
+        const auto& scope = extension_scope::open();
+        const auto result = reset_all(storage);
+        EXPECT_EQ(result.reset, 10u);
+        EXPECT_EQ(result.deferred, 10u);
+    }
+    reset_all(storage);
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(reset_all, releases_on_a_pool) {
+    work_stealing_pool pool(3);
+    auto storage = make_storage(1000);
+    weak_extender<counted> held(storage[10]);
+    {
+        const auto& scoped = held.lock();
+        const auto result = reset_all(pool, storage, 16);
+        EXPECT_EQ(result.reset, 1000u);
+        EXPECT_EQ(result.deferred, 1u);
+        EXPECT_EQ(counted::alive.load(), 1);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+    for (const auto& element : storage) {
+        EXPECT_FALSE(element);
+    }
+}
+
+TEST(reset_all, destroys_every_resource_on_a_pool) {
+    work_stealing_pool pool(3);
+    auto storage = make_storage(1000);
+    for (std::size_t i = 0; i < storage.size(); i += 10) {
+        storage[i].reset();
+    }
+    const auto result = reset_all(pool, storage);
+    EXPECT_EQ(result.reset, 900u);
+    EXPECT_EQ(result.deferred, 0u);
+    EXPECT_EQ(counted::alive.load(), 0);
+    for (const auto& element : storage) {
+        EXPECT_FALSE(element);
+    }
+}
+
+} // namespace
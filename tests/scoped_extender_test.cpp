@@ -0,0 +1,122 @@
+#include <atomic>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) { ++alive; }
+    ~counted() { --alive; }
+
+    static std::atomic<int> alive;
+    int value;
+};
+std::atomic<int> counted::alive{0};
+
+/**
+ * @brief Holds a scoped_extender outside of a stack frame, so that it can be
+ * reset on another thread the way a coroutine resumed elsewhere does
+ */
+class detached_extender {
+public:
+    explicit detached_extender(const weak_extender<counted>& weak) {
+        new (&storage) scoped_extender<counted>(weak.lock());
+    }
+    ~detached_extender() { get().~scoped_extender(); }
+
+    scoped_extender<counted>& get() { return *reinterpret_cast<scoped_extender<counted>*>(&storage); }
+
+private:
+    std::aligned_storage<sizeof(scoped_extender<counted>), alignof(scoped_extender<counted>)>::type storage;
+};
+
+TEST(scoped_extender, nested_lock_borrows_from_the_outer_one) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    const auto& outer = weak.lock();
+    const auto& nested = weak.lock();
+    ASSERT_FALSE(nested.empty());
+    owner.reset();
+    EXPECT_EQ(nested->value, 1);
+    EXPECT_EQ(counted::alive.load(), 1);
+}
+
+TEST(scoped_extender, nested_lock_reset_on_another_thread) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    {
+        const auto& outer = weak.lock();
+        detached_extender nested(weak);
+        ASSERT_FALSE(nested.get().empty());
+        std::thread([&] { nested.get().reset(); }).join();
+        owner.reset();
+        EXPECT_EQ(outer->value, 1);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+
+    // the entry of the thread does not outlive the resource
+    auto replacement = make_unique_extendable<counted>(2);
+    weak_extender<counted> replacement_weak(replacement);
+    const auto& locked = replacement_weak.lock();
+    ASSERT_FALSE(locked.empty());
+    EXPECT_EQ(locked->value, 2);
+}
+
+TEST(scoped_extender, outer_lock_reset_on_another_thread) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    detached_extender outer(weak);
+    {
+        const auto& nested = weak.lock();
+        std::thread([&] { outer.get().reset(); }).join();
+        owner.reset();
+        // the reference queued by the other thread keeps it alive
+        EXPECT_EQ(nested->value, 1);
+        EXPECT_EQ(counted::alive.load(), 1);
+    }
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(scoped_extender, reset_after_the_locking_thread_exited) {
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    detached_extender* outer = nullptr;
+    detached_extender* nested = nullptr;
+    std::thread([&] {
+        outer = new detached_extender(weak);
+        nested = new detached_extender(weak);
+    }).join();
+    owner.reset();
+    EXPECT_EQ(counted::alive.load(), 1);
+    delete outer;
+    EXPECT_EQ(nested->get()->value, 1);
+    delete nested;
+    EXPECT_EQ(counted::alive.load(), 0);
+}
+
+TEST(scoped_extender, concurrent_resets_on_other_threads) {
+    constexpr int rounds = 200;
+    for (int round = 0; round < rounds; ++round) {
+        auto owner = make_unique_extendable<counted>(round);
+        weak_extender<counted> weak(owner);
+        {
+            const auto& outer = weak.lock();
+            detached_extender first(weak);
+            detached_extender second(weak);
+            std::thread a([&] { first.get().reset(); });
+            std::thread b([&] { second.get().reset(); });
+            owner.reset();
+            a.join();
+            b.join();
+            EXPECT_EQ(outer->value, round);
+        }
+        EXPECT_EQ(counted::alive.load(), 0);
+    }
+}
+
+} // namespace
@@ -0,0 +1,91 @@
+#include <functional>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct manual_executor {
+    void submit(std::function<void()> task) { tasks.push_back(std::move(task)); }
+
+    std::vector<std::function<void()>> tasks;
+};
+
+struct counted {};
+struct exposed {};
+
+TEST(extendable_stats, snapshot_counts_every_lock) {
+    auto owner = make_unique_extendable<counted>();
+    weak_extender<counted> weak(owner);
+    {
+        const auto& outer = weak.lock();
+        const auto& nested = weak.lock();
+        EXPECT_FALSE(nested.empty());
+    }
+    {
+        const auto& scope = extension_scope::open();
+        EXPECT_FALSE(weak.lock(scope).empty());
+    }
+    {
+        const auto& outliving = weak.lock();
+        owner.reset();
+        EXPECT_TRUE(weak.lock().empty());
+        const auto& scope = extension_scope::open();
+        EXPECT_TRUE(weak.lock(scope).empty());
+    }
+    EXPECT_TRUE(weak.lock().empty());
+    {
+        const auto& scope = extension_scope::open();
+        EXPECT_TRUE(weak.lock(scope).empty());
+    }
+
+    manual_executor executor;
+    auto pending = make_unique_extendable_async<counted>(executor);
+    EXPECT_TRUE(weak_extender<counted>(pending).lock().empty());
+    for (auto& task : executor.tasks) {
+        task();
+    }
+
+    const auto snapshot = extendable_stats<counted>::snapshot();
+    // the outer, nested and scoped locks and the one that outlived its owner
+    EXPECT_EQ(snapshot.lock_hits, 4u);
+    // two while marked, two after the destruction and one while constructing
+    EXPECT_EQ(snapshot.lock_misses, 5u);
+    EXPECT_EQ(snapshot.lock_reset_races, 2u);
+    EXPECT_EQ(snapshot.outlived_owner, 1u);
+}
+
+TEST(extendable_stats_exposition, writes_the_text_format) {
+    auto owner = make_unique_extendable<exposed>();
+    weak_extender<exposed> weak(owner);
+    weak.lock();
+    weak.lock();
+    owner.reset();
+    weak.lock();
+
+    std::ostringstream out;
+    extendable_stats_exposition::write(out);
+    const auto text = out.str();
+
+    const std::regex comment("# (HELP [a-z_]+ .+|TYPE [a-z_]+ counter)");
+    const std::regex sample("[a-z_]+\\{type=\"[^\"]+\"\\} [0-9]+");
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        EXPECT_TRUE(std::regex_match(line, comment) || std::regex_match(line, sample)) << line;
+    }
+
+    const std::string label = std::string("{type=\"") + typeid(exposed).name() + "\"} ";
+    EXPECT_NE(text.find("extendable_lock_hits_total" + label + "2\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("extendable_lock_misses_total" + label + "1\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("extendable_lock_reset_races_total" + label + "0\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("extendable_outlived_owner_total" + label + "0\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("# TYPE extendable_lock_hits_total counter\n"), std::string::npos);
+}
+
+} // namespace
@@ -0,0 +1,133 @@
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_parallel.h"
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) {}
+
+    int value;
+};
+
+struct pooled {
+    ~pooled() {
+        std::lock_guard<std::mutex> lock(mutex);
+        destroyed_by.push_back(std::this_thread::get_id());
+    }
+
+    static std::mutex mutex;
+    static std::vector<std::thread::id> destroyed_by;
+};
+std::mutex pooled::mutex;
+std::vector<std::thread::id> pooled::destroyed_by;
+
+} // namespace
+
+template <>
+struct extendable_destruction_policy<pooled> : pooled_destruction<pooled> {};
+
+namespace {
+
+TEST(work_stealing_pool, pinned_tasks_reach_every_sleeping_worker) {
+    work_stealing_pool pool(4);
+    std::atomic<int> mismatched{0};
+    for (int round = 0; round < 100; ++round) {
+        for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+            pool.submit_pinned(worker, [&, worker] {
+                if (pool.current_worker() != worker) {
+                    ++mismatched;
+                }
+            });
+        }
+        pool.wait_idle();
+    }
+    EXPECT_EQ(mismatched.load(), 0);
+    EXPECT_EQ(pool.statistics().completed_tasks, 400u);
+}
+
+TEST(work_stealing_pool, stealable_task_wakes_another_worker) {
+    work_stealing_pool pool(2);
+    std::promise<std::size_t> stolen_by;
+    // the submitting worker blocks until another one has run the task it queued
+    pool.submit([&] {
+        std::promise<void> ran;
+        pool.submit([&] {
+            stolen_by.set_value(pool.current_worker());
+            ran.set_value();
+        });
+        ran.get_future().wait();
+    });
+    const auto thief = stolen_by.get_future().get();
+    pool.wait_idle();
+    EXPECT_LT(thief, pool.size());
+}
+
+TEST(work_stealing_pool, affine_backlog_wakes_a_thief) {
+    work_stealing_pool pool(2);
+    auto owner = make_unique_extendable<counted>(1);
+    weak_extender<counted> weak(owner);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> ran{0};
+    // the first task blocks the worker the resource is routed to
+    pool.submit_extending(weak, [&](counted&) { released.wait(); });
+    for (int i = 0; i < 3; ++i) {
+        pool.submit_extending(weak, [&](counted&) { ++ran; });
+    }
+    while (ran.load() < 2) {
+        std::this_thread::yield();
+    }
+    release.set_value();
+    pool.wait_idle();
+    EXPECT_EQ(ran.load(), 3);
+    // the resource follows the thief, the tasks after the stolen one are routed to it
+    EXPECT_GE(pool.statistics().stolen_extending_tasks, 1u);
+}
+
+TEST(pooled_destruction, destroys_on_the_pool_until_detached) {
+    pooled::destroyed_by.clear();
+    {
+        work_stealing_pool pool(1);
+        pooled_destruction<pooled>::attach(pool);
+        for (int i = 0; i < 10; ++i) {
+            make_unique_extendable<pooled>().reset();
+        }
+        pool.wait_idle();
+        pooled_destruction<pooled>::detach();
+        ASSERT_EQ(pooled::destroyed_by.size(), 10u);
+        for (const auto& thread : pooled::destroyed_by) {
+            EXPECT_NE(thread, std::this_thread::get_id());
+        }
+    }
+    make_unique_extendable<pooled>().reset();
+    ASSERT_EQ(pooled::destroyed_by.size(), 11u);
+    EXPECT_EQ(pooled::destroyed_by.back(), std::this_thread::get_id());
+}
+
+TEST(pooled_destruction, detach_waits_for_concurrent_destructions) {
+    std::atomic<bool> stop{false};
+    std::thread destroying([&] {
+        while (!stop.load()) {
+            make_unique_extendable<pooled>().reset();
+        }
+    });
+    for (int round = 0; round < 50; ++round) {
+        // the pool is destroyed right after it is detached
+        work_stealing_pool pool(1);
+        pooled_destruction<pooled>::attach(pool);
+        std::this_thread::yield();
+        pooled_destruction<pooled>::detach();
+    }
+    stop = true;
+    destroying.join();
+}
+
+} // namespace
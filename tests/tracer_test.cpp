@@ -0,0 +1,205 @@
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "extendable_unique_ownership.h"
+
+namespace {
+
+struct traced {};
+
+/**
+ * @brief Checks that a document is a single well-formed JSON value, just
+ * enough of the grammar for what the tracer writes and what it must not
+ */
+class json_checker {
+public:
+    explicit json_checker(const std::string& text) : text(text) {}
+
+    bool document() {
+        return value() && (skip_whitespace(), position == text.size());
+    }
+
+private:
+    bool value() {
+        skip_whitespace();
+        if (position == text.size()) {
+            return false;
+        }
+        switch (text[position]) {
+        case '{':
+            return object();
+        case '[':
+            return array();
+        case '"':
+            return string();
+        default:
+            return number() || literal("true") || literal("false") || literal("null");
+        }
+    }
+
+    bool object() {
+        ++position;
+        skip_whitespace();
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            skip_whitespace();
+            if (!string() || (skip_whitespace(), !consume(':')) || !value()) {
+                return false;
+            }
+            skip_whitespace();
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool array() {
+        ++position;
+        skip_whitespace();
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!value()) {
+                return false;
+            }
+            skip_whitespace();
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool string() {
+        if (!consume('"')) {
+            return false;
+        }
+        while (position < text.size() && text[position] != '"') {
+            const auto character = static_cast<unsigned char>(text[position]);
+            if (character < 0x20) {
+                return false;
+            }
+            position += character == '\\' ? 2 : 1;
+        }
+        return consume('"');
+    }
+
+    bool number() {
+        const auto start = position;
+        consume('-');
+        const auto digits = [&] {
+            const auto first = position;
+            while (position < text.size() && std::isdigit(static_cast<unsigned char>(text[position]))) {
+                ++position;
+            }
+            return position != first;
+        };
+        if (!digits()) {
+            position = start;
+            return false;
+        }
+        return !consume('.') || digits();
+    }
+
+    bool literal(const char* expected) {
+        const std::string word(expected);
+        if (text.compare(position, word.size(), word) != 0) {
+            return false;
+        }
+        position += word.size();
+        return true;
+    }
+
+    bool consume(char expected) {
+        if (position < text.size() && text[position] == expected) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    void skip_whitespace() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+            ++position;
+        }
+    }
+
+    const std::string& text;
+    std::size_t position = 0;
+};
+
+std::string dumped() {
+    std::ostringstream out;
+    extendable_tracer::dump(out);
+    return out.str();
+}
+
+std::size_t occurrences(const std::string& text, const std::string& pattern) {
+    std::size_t count = 0;
+    for (auto found = text.find(pattern); found != std::string::npos; found = text.find(pattern, found + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+TEST(extendable_tracer, dump_is_well_formed_json) {
+    extendable_tracer::set_sampling(1);
+    {
+        auto owner = make_unique_extendable<traced>();
+        weak_extender<traced> weak(owner);
+        const auto& extender = weak.lock();
+        owner.reset();
+        EXPECT_TRUE(weak.lock().empty());
+    }
+
+    const auto trace = dumped();
+    EXPECT_TRUE(json_checker(trace).document()) << trace;
+    // the span of the resource, reset and lock on it, the extender and the failed lock
+    for (const char* phase : {"\"ph\":\"b\"", "\"ph\":\"e\"", "\"ph\":\"n\"", "\"ph\":\"X\"", "\"ph\":\"i\""}) {
+        EXPECT_NE(trace.find(phase), std::string::npos) << phase;
+    }
+    EXPECT_NE(trace.find("\"args\":{\"event\":\"reset\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"event\":\"lock\"}"), std::string::npos);
+}
+
+TEST(extendable_tracer, ring_keeps_the_last_events) {
+    extendable_tracer::set_sampling(1);
+    std::thread recording([] {
+        auto owner = make_unique_extendable<traced>();
+        weak_extender<traced> weak(owner);
+        for (std::size_t i = 0; i < extendable_tracer::ring_capacity; ++i) {
+            weak.lock();
+        }
+    });
+    recording.join();
+
+    const auto trace = dumped();
+    EXPECT_TRUE(json_checker(trace).document());
+    // the create of the resource is overwritten, the ring ends with its reset and destroy
+    EXPECT_GE(occurrences(trace, "{\"pid\""), extendable_tracer::ring_capacity);
+    EXPECT_GE(occurrences(trace, "\"ph\":\"X\""), extendable_tracer::ring_capacity / 2 - 1);
+}
+
+TEST(extendable_tracer, dump_while_recording_is_well_formed) {
+    extendable_tracer::set_sampling(1);
+    std::atomic<bool> stop{false};
+    std::thread recording([&] {
+        while (!stop.load()) {
+            auto owner = make_unique_extendable<traced>();
+            weak_extender<traced> weak(owner);
+            weak.lock();
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        const auto trace = dumped();
+        EXPECT_TRUE(json_checker(trace).document());
+    }
+    stop = true;
+    recording.join();
+}
+
+} // namespace
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "extendable_weak_set.h"
+
+namespace {
+
+struct counted {
+    explicit counted(int value) : value(value) {}
+
+    int value;
+};
+
+constexpr std::size_t slot_count = 1 << 12;
+
+struct resources {
+    explicit resources(std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            owners.push_back(make_unique_extendable<counted>(static_cast<int>(i)));
+            extenders.emplace_back(owners.back());
+        }
+    }
+
+    std::vector<unique_extendable_ptr<counted>> owners;
+    std::vector<weak_extender<counted>> extenders;
+};
+
+/**
+ * @brief The fastest of a few rounds of lookups of extenders that are not
+ * in the set
+ */
+std::chrono::nanoseconds missing_lookups(
+    const extendable_weak_set<counted>& set, const std::vector<weak_extender<counted>>& missing) {
+    auto fastest = std::chrono::nanoseconds::max();
+    for (int round = 0; round < 5; ++round) {
+        const auto started = std::chrono::steady_clock::now();
+        std::size_t found = 0;
+        for (const auto& extender : missing) {
+            found += set.contains(extender) ? 1 : 0;
+        }
+        fastest = std::min(fastest, std::chrono::steady_clock::now() - started);
+        EXPECT_EQ(found, 0u);
+    }
+    return fastest;
+}
+
+TEST(extendable_weak_set, erased_slots_are_reused) {
+    extendable_weak_set<counted> set(slot_count);
+    resources stored(slot_count);
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& extender : stored.extenders) {
+            EXPECT_TRUE(set.insert(extender));
+        }
+        EXPECT_EQ(set.size(), slot_count);
+        for (const auto& extender : stored.extenders) {
+            EXPECT_TRUE(set.erase(extender));
+        }
+        EXPECT_EQ(set.size(), 0u);
+    }
+}
+
+TEST(extendable_weak_set, lookup_miss_stays_short_after_churn) {
+    resources stored(slot_count);
+    resources missing(256);
+
+    extendable_weak_set<counted> fresh(slot_count);
+    extendable_weak_set<counted> churned(slot_count);
+    for (const auto& extender : stored.extenders) {
+        churned.insert(extender);
+    }
+    // erased in two passes, so that the first one leaves erased slots followed by full ones
+    for (std::size_t i = 0; i < slot_count; i += 2) {
+        churned.erase(stored.extenders[i]);
+    }
+    for (std::size_t i = 1; i < slot_count; i += 2) {
+        churned.erase(stored.extenders[i]);
+    }
+
+    // every miss used to walk the whole table of erased slots
+    EXPECT_LT(missing_lookups(churned, missing.extenders), 10 * missing_lookups(fresh, missing.extenders));
+}
+
+TEST(extendable_weak_set, lookups_find_kept_entries_while_others_churn) {
+    extendable_weak_set<counted> set(256);
+    resources kept(32);
+    resources churned(96);
+    for (const auto& extender : kept.extenders) {
+        ASSERT_TRUE(set.insert(extender));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> missed{0};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            for (const auto& extender : kept.extenders) {
+                if (!set.contains(extender)) {
+                    ++missed;
+                }
+            }
+        }
+    });
+    for (int round = 0; round < 2000; ++round) {
+        for (const auto& extender : churned.extenders) {
+            set.insert(extender);
+        }
+        for (const auto& extender : churned.extenders) {
+            set.erase(extender);
+        }
+    }
+    stop = true;
+    reader.join();
+    EXPECT_EQ(missed.load(), 0);
+    EXPECT_EQ(set.size(), kept.extenders.size());
+}
+
+} // namespace